@@ -27,6 +27,7 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_state.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -38,6 +39,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/timeline.hpp>
 #include <array>
 #include <algorithm>
 #include <cstdarg>
@@ -204,6 +206,17 @@ run_async(program& p, const parameter_map& params, void* s, std::string_view nam
     return p.eval(params, exec_env);
 }
 
+std::vector<argument>
+run_with_trace(program& p, const parameter_map& params, const char* trace_file)
+{
+    timeline t;
+    execution_environment exec_env;
+    exec_env.trace = &t;
+    auto result    = p.eval(params, exec_env);
+    t.write_chrome_trace(std::string(trace_file));
+    return result;
+}
+
 template <class Value>
 std::vector<const char*> get_names(const std::unordered_map<std::string, Value>& m)
 {
@@ -287,6 +300,11 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(execution_state& s, const parameter_map& params)
+{
+    return s.eval(params);
+}
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
@@ -609,6 +627,17 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_execution_state;
+struct migraphx_execution_state
+{
+    template <class... Ts>
+    migraphx_execution_state(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::execution_state object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -1733,6 +1762,23 @@ extern "C" migraphx_status migraphx_program_run_async(migraphx_arguments_t* out,
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_program_run_with_trace(migraphx_arguments_t* out,
+                                migraphx_program_t program,
+                                migraphx_program_parameters_t params,
+                                const char* trace_file)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(program == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter program: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_arguments_t>(
+            migraphx::run_with_trace((program->object), (params->object), (trace_file)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status
 migraphx_program_equal(bool* out, const_migraphx_program_t program, const_migraphx_program_t x)
 {
@@ -1757,6 +1803,83 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_execution_state_destroy(migraphx_execution_state_t execution_state)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((execution_state)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_state_assign_to(migraphx_execution_state_t output,
+                                   const_migraphx_execution_state_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_state_create(migraphx_execution_state_t* execution_state,
+                                const_migraphx_program_t p)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        *execution_state = object_cast<migraphx_execution_state_t>(
+            allocate<migraphx::execution_state>((p->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_state_run(migraphx_arguments_t* out,
+                             migraphx_execution_state_t execution_state,
+                             migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(execution_state == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter execution_state: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_arguments_t>(
+            migraphx::run((execution_state->object), (params->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_state_bind_output(migraphx_execution_state_t execution_state,
+                                     size_t index,
+                                     const_migraphx_argument_t output)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(execution_state == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter execution_state: Null pointer");
+        if(output == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter output: Null pointer");
+        (execution_state->object).bind_output((index), (output->object));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_execution_state_bind_output_by_name(migraphx_execution_state_t execution_state,
+                                             const char* name,
+                                             const_migraphx_argument_t output)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(execution_state == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter execution_state: Null pointer");
+        if(output == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter output: Null pointer");
+        (execution_state->object).bind_output((name), (output->object));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
@@ -116,6 +116,9 @@ typedef const struct migraphx_module* const_migraphx_module_t;
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_execution_state* migraphx_execution_state_t;
+typedef const struct migraphx_execution_state* const_migraphx_execution_state_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -462,6 +465,12 @@ MIGRAPHX_C_EXPORT migraphx_status migraphx_program_run_async(migraphx_arguments_
                                                              void* s,
                                                              const char* name);
 
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_program_run_with_trace(migraphx_arguments_t* out,
+                                migraphx_program_t program,
+                                migraphx_program_parameters_t params,
+                                const char* trace_file);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_program_equal(bool* out,
                                                          const_migraphx_program_t program,
                                                          const_migraphx_program_t x);
@@ -469,6 +478,30 @@ MIGRAPHX_C_EXPORT migraphx_status migraphx_program_equal(bool* out,
 MIGRAPHX_C_EXPORT migraphx_status migraphx_program_experimental_get_context(
     migraphx_context_t* out, const_migraphx_program_t program);
 
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_state_destroy(migraphx_execution_state_t execution_state);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_execution_state_assign_to(
+    migraphx_execution_state_t output, const_migraphx_execution_state_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_execution_state_create(
+    migraphx_execution_state_t* execution_state, const_migraphx_program_t p);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_state_run(migraphx_arguments_t* out,
+                             migraphx_execution_state_t execution_state,
+                             migraphx_program_parameters_t params);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_state_bind_output(migraphx_execution_state_t execution_state,
+                                     size_t index,
+                                     const_migraphx_argument_t output);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_execution_state_bind_output_by_name(migraphx_execution_state_t execution_state,
+                                             const char* name,
+                                             const_migraphx_argument_t output);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
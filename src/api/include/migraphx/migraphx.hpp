@@ -1199,6 +1199,19 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
         return arguments(pout, own{});
     }
 
+    /// Run the program and write a Chrome trace of the evaluation to the file, which can be
+    /// opened in Perfetto
+    arguments eval_with_trace(const program_parameters& pparams, const char* trace_file) const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_program_run_with_trace,
+             &pout,
+             this->get_handle_ptr(),
+             pparams.get_handle_ptr(),
+             trace_file);
+        return arguments(pout, own{});
+    }
+
     void print() const { call(&migraphx_program_print, this->get_handle_ptr()); }
 
     program sort()
@@ -1238,6 +1251,48 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return not(px == py); }
 };
 
+/// State used to run a compiled program, several states can run the same program concurrently.
+/// The program must outlive the states created from it.
+struct execution_state : MIGRAPHX_HANDLE_BASE(execution_state)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(execution_state)
+
+    execution_state(const program& p)
+    {
+        this->make_handle(&migraphx_execution_state_create, p.get_handle_ptr());
+    }
+
+    /// Run the program using the inputs passed in
+    arguments eval(const program_parameters& pparams) const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_execution_state_run,
+             &pout,
+             this->get_handle_ptr(),
+             pparams.get_handle_ptr());
+        return arguments(pout, own{});
+    }
+
+    /// Write an output of the program to the buffer of the argument, the argument is returned
+    /// by eval for that output and must stay alive while the state is evaluated
+    void bind_output(size_t index, const argument& output) const
+    {
+        call(&migraphx_execution_state_bind_output,
+             this->get_handle_ptr(),
+             index,
+             output.get_handle_ptr());
+    }
+
+    /// Bind an output by its parameter name, such as "main:#output_0"
+    void bind_output(const std::string& name, const argument& output) const
+    {
+        call(&migraphx_execution_state_bind_output_by_name,
+             this->get_handle_ptr(),
+             name.c_str(),
+             output.get_handle_ptr());
+    }
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
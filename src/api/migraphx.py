@@ -286,6 +286,12 @@ def program(h):
                  name='const char *'),
              invoke='migraphx::run_async($@)',
              returns='std::vector<migraphx::argument>')
+    h.method('run_with_trace',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>',
+                 trace_file='const char*'),
+             invoke='migraphx::run_with_trace($@)',
+             returns='std::vector<migraphx::argument>')
     h.method('equal',
              api.params(x='const migraphx::program&'),
              invoke='migraphx::equal($@)',
@@ -297,6 +303,22 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def execution_state(h):
+    h.constructor('create', api.params(p='const migraphx::program&'))
+    h.method('run',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             invoke='migraphx::run($@)',
+             returns='std::vector<migraphx::argument>')
+    h.method('bind_output',
+             api.params(index='size_t', output='const migraphx::argument&'))
+    h.method('bind_output_by_name',
+             api.params(name='const char*',
+                        output='const migraphx::argument&'),
+             fname='bind_output')
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
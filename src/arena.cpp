@@ -0,0 +1,232 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/arena.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_ARENA)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_ARENA)
+
+static thread_local arena* current_arena = nullptr; // NOLINT
+
+static std::size_t align_up(std::size_t n)
+{
+    return (n + arena::alignment - 1) & ~(arena::alignment - 1);
+}
+
+static std::shared_ptr<char> allocate_aligned(std::size_t n)
+{
+    auto* p = static_cast<char*>(::operator new(n, std::align_val_t{arena::alignment}));
+    return {p, [](char* x) { ::operator delete(x, std::align_val_t{arena::alignment}); }};
+}
+
+struct arena_block
+{
+    std::shared_ptr<char> data;
+    std::size_t capacity = 0;
+    std::size_t offset   = 0;
+
+    // None of the allocations from the block are alive
+    bool unused() const
+    {
+        if(data.use_count() != 1)
+            return false;
+        // Synchronize with the threads that released the allocations
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+};
+
+struct arena_impl
+{
+    // Blocks that are kept when the results of previous evaluations are still alive
+    static constexpr std::size_t max_blocks = 4;
+
+    std::mutex mutex;
+    std::vector<arena_block> blocks;
+    std::size_t current = 0;
+    // Bytes allocated since the last reset
+    std::size_t used = 0;
+    arena_stats stats;
+
+    arena_block& new_block(std::size_t n)
+    {
+        if(blocks.size() >= max_blocks)
+        {
+            // The arguments still using the blocks keep them alive
+            blocks.erase(std::remove_if(blocks.begin(),
+                                        blocks.end(),
+                                        [](const arena_block& b) { return not b.unused(); }),
+                         blocks.end());
+            if(blocks.size() >= max_blocks)
+                blocks.erase(blocks.begin());
+        }
+        n = align_up(n);
+        blocks.push_back({allocate_aligned(n), n, 0});
+        stats.blocks++;
+        current = blocks.size() - 1;
+        return blocks.back();
+    }
+
+    // Use an unused block with room for n bytes, or allocate one
+    arena_block& find_block(std::size_t n)
+    {
+        auto it = std::find_if(blocks.begin(), blocks.end(), [&](const arena_block& b) {
+            return b.capacity >= n and b.unused();
+        });
+        if(it == blocks.end())
+            return new_block(n);
+        it->offset = 0;
+        current    = it - blocks.begin();
+        return *it;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        used = 0;
+        if(blocks.empty())
+            return;
+        // Release the unused blocks that are too small to hold a whole evaluation, so the arena
+        // settles on one block
+        auto need = stats.high_water;
+        blocks.erase(std::remove_if(blocks.begin(),
+                                    blocks.end(),
+                                    [&](const arena_block& b) {
+                                        return b.capacity < need and b.unused();
+                                    }),
+                     blocks.end());
+        find_block(need);
+    }
+
+    bool owns(const char* p)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::any_of(blocks.begin(), blocks.end(), [&](const arena_block& b) {
+            return p >= b.data.get() and p < b.data.get() + b.capacity;
+        });
+    }
+
+    std::shared_ptr<char> allocate(std::size_t n)
+    {
+        n = align_up(n);
+        std::lock_guard<std::mutex> lock(mutex);
+        if(blocks.empty())
+            new_block(std::max(n, stats.high_water));
+        else if(blocks[current].unused())
+            blocks[current].offset = 0;
+        if(blocks[current].offset + n > blocks[current].capacity)
+            find_block(std::max(n, 2 * blocks[current].capacity));
+        auto& b = blocks[current];
+        auto* p = b.data.get() + b.offset;
+        b.offset += n;
+        used += n;
+        stats.allocations++;
+        stats.high_water = std::max(stats.high_water, used);
+        // The allocation shares the ownership of the block
+        return {b.data, p};
+    }
+};
+
+arena::arena() : impl(std::make_unique<arena_impl>()) {}
+
+arena::~arena()
+{
+    if(enabled(MIGRAPHX_TRACE_ARENA{}) and impl->stats.allocations > 0)
+        std::cout << "Arena: " << this->get_stats() << std::endl;
+}
+
+std::shared_ptr<char> arena::allocate(std::size_t bytes)
+{
+    static const bool disabled = enabled(MIGRAPHX_DISABLE_ARENA{});
+    if(disabled)
+        return allocate_aligned(align_up(bytes));
+    return impl->allocate(bytes);
+}
+
+argument arena::allocate(const shape& s) { return {s, this->allocate(s.bytes())}; }
+
+void arena::reset() { impl->reset(); }
+
+argument arena::detach(const argument& a) const
+{
+    if(a.empty())
+        return a;
+    if(a.get_shape().type() == shape::tuple_type)
+    {
+        auto elements = a.get_sub_objects();
+        std::transform(elements.begin(), elements.end(), elements.begin(), [&](const auto& x) {
+            return this->detach(x);
+        });
+        return elements;
+    }
+    if(not impl->owns(a.data()))
+        return a;
+    // Not allocated with argument{shape}, which could use the arena again
+    auto bytes = a.get_shape().bytes();
+    argument result{a.get_shape(), make_shared_array<char>(bytes)};
+    std::copy(a.data(), a.data() + bytes, result.data());
+    return result;
+}
+
+arena_stats arena::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    auto result     = impl->stats;
+    result.capacity = 0;
+    for(const auto& b : impl->blocks)
+        result.capacity += b.capacity;
+    return result;
+}
+
+void arena::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    impl->stats = arena_stats{};
+}
+
+arena* arena::current() { return current_arena; }
+
+std::ostream& operator<<(std::ostream& os, const arena_stats& s)
+{
+    os << "Allocations: " << s.allocations << ", Blocks: " << s.blocks
+       << ", High water: " << s.high_water << " bytes, Capacity: " << s.capacity << " bytes";
+    return os;
+}
+
+arena_scope::arena_scope(arena& a) : previous(current_arena) { current_arena = &a; }
+
+arena_scope::~arena_scope() { current_arena = previous; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -22,7 +22,9 @@
  * THE SOFTWARE.
  */
 #include <migraphx/argument.hpp>
+#include <migraphx/arena.hpp>
 #include <migraphx/functional.hpp>
+#include <algorithm>
 #include <unordered_map>
 
 namespace migraphx {
@@ -30,7 +32,16 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 argument::argument(const shape& s) : m_shape(s)
 {
-    auto buffer = make_shared_array<char>(s.bytes());
+    std::shared_ptr<char> buffer;
+    if(auto* a = arena::current())
+    {
+        buffer = a->allocate(s.bytes());
+        std::fill_n(buffer.get(), s.bytes(), 0);
+    }
+    else
+    {
+        buffer = make_shared_array<char>(s.bytes());
+    }
     assign_buffer({[=]() mutable { return buffer.get(); }});
 }
 
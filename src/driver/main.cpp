@@ -47,6 +47,9 @@
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
 #include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/quantization.hpp>
@@ -54,8 +57,15 @@
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/register_target.hpp>
+#include <migraphx/time.hpp>
+#ifdef HAVE_CPU
+#include <migraphx/cpu/numa.hpp>
+#endif
 
+#include <cstdint>
 #include <fstream>
+#include <numeric>
+#include <unordered_map>
 
 namespace migraphx {
 namespace driver {
@@ -507,6 +517,9 @@ struct compiler
            {"--exhaustive-tune"},
            ap.help("Exhastively search for best tuning parameters for kernels"),
            ap.set_value(true));
+        ap(co.fp16_mode,
+           {"--fp16-mode"},
+           ap.help("How fp16 is computed: native, storage (fp16 data with fp32 compute) or float"));
         ap(to_fp16, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(true));
         ap(to_int8, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(true));
         ap(to_fp8, {"--fp8"}, ap.help("Quantize for fp8e4m3fnuz type"), ap.set_value(true));
@@ -674,7 +687,14 @@ struct compile : command<compile>
 struct run_cmd : command<run_cmd>
 {
     compiler c;
-    void parse(argument_parser& ap) { c.parse(ap); }
+    std::string trace_file;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(trace_file,
+           {"--trace"},
+           ap.help("Write a Chrome trace of the evaluation to the file, to view in Perfetto"));
+    }
 
     void run()
     {
@@ -682,7 +702,10 @@ struct run_cmd : command<run_cmd>
         auto p = c.compile();
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
-        p.eval(m);
+        if(trace_file.empty())
+            p.eval(m);
+        else
+            write_trace(p, m, trace_file, 1);
         std::cout << p << std::endl;
     }
 };
@@ -691,10 +714,26 @@ struct perf : command<perf>
 {
     compiler c;
     unsigned n = 100;
+    std::string trace_file;
+    std::size_t concurrency = 0;
+    double duration         = 10;
+    std::string json_file;
     void parse(argument_parser& ap)
     {
         c.parse(ap);
         ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to run for perf report"));
+        ap(trace_file,
+           {"--trace"},
+           ap.help("Write a Chrome trace of the iterations to the file, to view in Perfetto"));
+        ap(concurrency,
+           {"--concurrency"},
+           ap.help("Measure throughput and latency with this many concurrent clients"));
+        ap(duration,
+           {"--duration"},
+           ap.help("Number of seconds to run the concurrent clients for"));
+        ap(json_file,
+           {"--json"},
+           ap.help("Write the throughput and latency results as json to the file"));
     }
 
     void run()
@@ -703,8 +742,141 @@ struct perf : command<perf>
         auto p = c.compile();
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
+        if(concurrency > 0)
+        {
+            std::cout << "Running throughput test ... " << std::endl;
+            auto stats = run_throughput(p, c.ct.get_target(), m, concurrency, duration, c.l.batch);
+            stats.print(std::cout);
+            if(not json_file.empty())
+                std::ofstream{json_file} << to_json_string(stats.to_value()) << std::endl;
+            return;
+        }
         std::cout << "Running performance report ... " << std::endl;
         p.perf_report(std::cout, n, m, c.l.batch);
+        if(not trace_file.empty())
+            write_trace(p, m, trace_file, n);
+    }
+};
+
+#ifdef HAVE_CPU
+struct numa : command<numa>
+{
+    std::size_t size = 256;
+    unsigned n       = 10;
+    void parse(argument_parser& ap)
+    {
+        ap(size, {"--size"}, ap.help("Megabytes of memory read by each measurement"));
+        ap(n, {"--iterations", "-n"}, ap.help("Number of times the memory is read"));
+    }
+
+    void run() const
+    {
+        const auto& nodes = cpu::get_numa_nodes();
+        auto elements     = size * 1024 * 1024 / sizeof(std::uint64_t);
+        std::cout << "Read bandwidth in GB/s of a thread on the node of each row, from memory "
+                     "placed on the node of each column"
+                  << std::endl;
+        for(std::size_t t = 0; t < nodes.size(); t++)
+        {
+            if(nodes[t].empty())
+                continue;
+            std::cout << "node " << t << ":";
+            for(std::size_t m = 0; m < nodes.size(); m++)
+            {
+                if(nodes[m].empty())
+                    continue;
+                std::vector<std::uint64_t> buffer;
+                // The pages are placed on the node of the thread that touches them first
+                cpu::run_on_numa_node(m, [&] { buffer.assign(elements, 1); });
+                std::uint64_t sum = 0;
+                double ms         = 0;
+                cpu::run_on_numa_node(t, [&] {
+                    ms = time<std::chrono::duration<double, std::milli>>([&] {
+                        for(unsigned i = 0; i < n; i++)
+                            sum += std::accumulate(buffer.begin(), buffer.end(), std::uint64_t{0});
+                    });
+                });
+                // Checking the sum also keeps the reads from being optimized away
+                if(sum != n * elements)
+                    MIGRAPHX_THROW("Invalid sum of the memory read");
+                std::cout << "\t" << n * elements * sizeof(std::uint64_t) / ms / 1e6;
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+#endif
+
+// Evaluate the main module the way the evaluator did before the execution plan resolved the
+// normalized operators
+static argument eval_normalize_each(const program& p, const parameter_map& params)
+{
+    const auto* mm = p.get_main_module();
+    auto& ctx      = p.get_context();
+    std::unordered_map<instruction_ref, argument> results;
+    std::vector<argument> values;
+    argument last;
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name() == "@param")
+        {
+            last = params.at(any_cast<builtin::param>(ins->get_operator()).parameter);
+        }
+        else
+        {
+            values.resize(ins->inputs().size());
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           values.begin(),
+                           [&](instruction_ref i) { return results.at(i); });
+            last = ins->normalized_operator().compute(ctx, ins->get_shape(), values);
+        }
+        results[ins] = last;
+    }
+    auto result = ctx.detach_memory(last);
+    ctx.reset_memory();
+    return result;
+}
+
+struct dispatch : command<dispatch>
+{
+    std::size_t instructions = 1000;
+    std::size_t n            = 100;
+    void parse(argument_parser& ap)
+    {
+        ap(instructions,
+           {"--instructions"},
+           ap.help("Number of instructions in the chain that is evaluated"));
+        ap(n, {"--iterations", "-n"}, ap.help("Number of times the chain is evaluated"));
+    }
+
+    void run() const
+    {
+        // The inputs of the reduce_sum operators are tiny, so the time is spent dispatching the
+        // instructions
+        program p;
+        auto* mm = p.get_main_module();
+        shape s{shape::float_type, {1, 1}};
+        auto x = mm->add_parameter("x", s);
+        for(std::size_t i = 0; i < instructions; i++)
+            x = mm->add_instruction(make_op("reduce_sum", {{"axes", {-1}}}), x);
+        p.compile(make_target("ref"));
+        parameter_map params = {{"x", generate_argument(s)}};
+        auto expected = p.eval(params).back();
+        if(eval_normalize_each(p, params) != expected)
+            MIGRAPHX_THROW("The results of the evaluations are different");
+        auto per_instruction = [&](auto f) {
+            auto ns = time<std::chrono::duration<double, std::nano>>([&] {
+                for(std::size_t i = 0; i < n; i++)
+                    f();
+            });
+            return ns / (instructions * n);
+        };
+        std::cout << "Normalized on each evaluation: "
+                  << per_instruction([&] { eval_normalize_each(p, params); }) << "ns/instruction"
+                  << std::endl;
+        std::cout << "Normalized with the execution plan: "
+                  << per_instruction([&] { p.eval(params); }) << "ns/instruction" << std::endl;
     }
 };
 
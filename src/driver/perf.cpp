@@ -26,7 +26,17 @@
 #include <migraphx/generate.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/instruction_ref.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/register_target.hpp>
+#include <migraphx/timeline.hpp>
+#include <migraphx/execution_state.hpp>
+#include <migraphx/time.hpp>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <numeric>
+#include <thread>
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
 #endif
@@ -131,6 +141,146 @@ bool is_offload_copy_set(const program& p)
     return param_ins.empty();
 }
 
+void write_trace(const program& p, const parameter_map& m, const std::string& file, std::size_t n)
+{
+    timeline t;
+    execution_environment exec_env;
+    exec_env.trace = &t;
+    for(std::size_t i = 0; i < n; i++)
+        p.eval(m, exec_env);
+    t.write_chrome_trace(file);
+    std::cout << "Trace written to " << file << std::endl;
+}
+
+double throughput_stats::requests_per_second() const
+{
+    if(seconds <= 0)
+        return 0;
+    return latencies.size() / seconds;
+}
+
+double throughput_stats::cpu_utilization() const
+{
+    if(seconds <= 0)
+        return 0;
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    return 100.0 * cpu_seconds / (seconds * threads);
+}
+
+double throughput_stats::percentile(double p) const
+{
+    if(latencies.empty())
+        return 0;
+    // Nearest rank, so the p999 of fewer than 1000 requests is the slowest one
+    auto rank = static_cast<std::size_t>(std::ceil(p * latencies.size()));
+    return latencies[std::min(std::max<std::size_t>(rank, 1), latencies.size()) - 1];
+}
+
+value throughput_stats::to_value() const
+{
+    value result;
+    result["concurrency"]           = concurrency;
+    result["batch"]                 = batch;
+    result["duration"]              = seconds;
+    result["requests"]              = latencies.size();
+    result["requests_per_second"]   = requests_per_second();
+    result["inferences_per_second"] = requests_per_second() * batch;
+    result["cpu_utilization"]       = cpu_utilization();
+    value latency;
+    latency["mean"] = latencies.empty() ? 0.0
+                                        : std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+                                              latencies.size();
+    latency["p50"]  = percentile(0.5);
+    latency["p90"]  = percentile(0.9);
+    latency["p99"]  = percentile(0.99);
+    latency["p999"] = percentile(0.999);
+    latency["max"]  = latencies.empty() ? 0.0 : latencies.back();
+    result["latency_ms"] = latency;
+    return result;
+}
+
+void throughput_stats::print(std::ostream& os) const
+{
+    os << "Concurrency: " << concurrency << std::endl;
+    os << "Batch size: " << batch << std::endl;
+    os << "Duration: " << seconds << "s" << std::endl;
+    os << "Requests: " << latencies.size() << std::endl;
+    os << "Rate: " << requests_per_second() << " requests/sec, "
+       << requests_per_second() * batch << " inferences/sec" << std::endl;
+    os << "Latency: p50 " << percentile(0.5) << "ms, p90 " << percentile(0.9) << "ms, p99 "
+       << percentile(0.99) << "ms, p999 " << percentile(0.999) << "ms" << std::endl;
+    os << "CPU utilization: " << cpu_utilization() << "% of "
+       << std::thread::hardware_concurrency() << " threads" << std::endl;
+}
+
+// The parameters that the program writes to, which are its outputs and its scratch memory
+static bool is_written_param(const std::string& name)
+{
+    return contains(name, "#output_") or name == "scratch";
+}
+
+throughput_stats run_throughput(const program& p,
+                                const target& t,
+                                const parameter_map& m,
+                                std::size_t concurrency,
+                                double duration,
+                                unsigned batch)
+{
+    concurrency = std::max<std::size_t>(concurrency, 1);
+    std::vector<execution_state> states;
+    std::vector<parameter_map> client_params(concurrency, m);
+    states.reserve(concurrency);
+    for(std::size_t i = 0; i < concurrency; i++)
+    {
+        // The clients share the inputs, but each one writes to its own buffers
+        for(auto&& x : client_params[i])
+        {
+            if(is_written_param(x.first))
+                x.second = t.allocate(x.second.get_shape());
+        }
+        states.emplace_back(p);
+        // Warm up each state so its scratch memory is allocated before timing
+        states.back().eval(client_params[i]);
+        states.back().finish();
+    }
+
+    std::vector<std::vector<double>> client_latencies(concurrency);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>{duration});
+    auto cpu_start = std::clock();
+    timer wall{};
+    std::vector<std::thread> clients;
+    clients.reserve(concurrency);
+    for(std::size_t i = 0; i < concurrency; i++)
+    {
+        clients.emplace_back([&, i] {
+            auto& state        = states[i];
+            const auto& params = client_params[i];
+            auto& latencies    = client_latencies[i];
+            while(std::chrono::steady_clock::now() < deadline)
+            {
+                latencies.push_back(time<std::chrono::duration<double, std::milli>>([&] {
+                    state.eval(params);
+                    state.finish();
+                }));
+            }
+        });
+    }
+    for(auto& client : clients)
+        client.join();
+
+    throughput_stats result;
+    result.concurrency = concurrency;
+    result.batch       = batch;
+    result.seconds     = wall.record<std::chrono::duration<double>>();
+    result.cpu_seconds = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    for(auto& latencies : client_latencies)
+        result.latencies.insert(result.latencies.end(), latencies.begin(), latencies.end());
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
 } // namespace  MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -25,6 +25,9 @@
 #define MIGRAPHX_GUARD_RTGLIB_PERF_HPP
 
 #include <migraphx/program.hpp>
+#include <migraphx/value.hpp>
+#include <ostream>
+#include <vector>
 
 namespace migraphx {
 namespace driver {
@@ -49,6 +52,42 @@ target get_target(bool gpu);
  */
 bool is_offload_copy_set(const program& p);
 
+/// Evaluate the program n times and write a Chrome trace of the evaluations to the file
+void write_trace(const program& p, const parameter_map& m, const std::string& file, std::size_t n);
+
+/// Latency and throughput of a program evaluated by several concurrent clients
+struct throughput_stats
+{
+    std::size_t concurrency = 0;
+    unsigned batch          = 1;
+    double seconds          = 0;
+    double cpu_seconds      = 0;
+    // Sorted latency of every request in milliseconds
+    std::vector<double> latencies = {};
+
+    double requests_per_second() const;
+    /// The CPU time of the process as a percentage of the time of all the hardware threads
+    double cpu_utilization() const;
+    /// Latency in milliseconds below which the fraction p of requests completed
+    double percentile(double p) const;
+
+    value to_value() const;
+    void print(std::ostream& os) const;
+};
+
+/**
+ * @brief Evaluate the program from concurrent clients for the duration in seconds
+ * @details Each client evaluates its own execution_state of the program back to back, and the
+ * latency of every request is recorded. The clients share the inputs in m, and the target
+ * allocates separate output and scratch parameters for each client.
+ */
+throughput_stats run_throughput(const program& p,
+                                const target& t,
+                                const parameter_map& m,
+                                std::size_t concurrency,
+                                double duration,
+                                unsigned batch = 1);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -0,0 +1,254 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/eval_pointwise.hpp>
+#include <migraphx/arena.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/permutation.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <cstring>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// The registers of a block stay in the L1 cache while every operator runs over them
+constexpr std::size_t pointwise_block_size = 1024;
+
+namespace {
+
+struct pointwise_step
+{
+    operation op;
+    bool context_free;
+    shape::type_t type;
+    std::vector<std::size_t> inputs;
+    std::size_t output;
+};
+
+// The registers are the parameters in order, then the literals, then the result of each step
+struct pointwise_program
+{
+    std::size_t nregisters = 0;
+    // Each literal is repeated over a whole block
+    std::vector<argument> literals;
+    std::vector<pointwise_step> steps;
+    std::size_t result = 0;
+};
+
+} // namespace
+
+static optional<pointwise_program>
+compile_pointwise(bool has_context, const_module_ref m, const std::vector<std::string>& pnames)
+{
+    pointwise_program p;
+    std::unordered_map<instruction_ref, std::size_t> registers;
+    for(const auto& name : pnames)
+        registers[m->get_parameter(name)] = p.nregisters++;
+    for(auto ins : iterator_for(*m))
+    {
+        if(ins->name() != "@literal")
+            continue;
+        const auto& lit = ins->get_literal();
+        if(lit.get_shape().elements() != 1)
+            return nullopt;
+        argument block{shape{lit.get_shape().type(), {pointwise_block_size}}};
+        visit_all(block, lit.get_argument())(
+            [](auto y, auto x) { std::fill(y.begin(), y.end(), x.front()); });
+        registers[ins] = p.nregisters++;
+        p.literals.push_back(block);
+    }
+    for(auto ins : iterator_for(*m))
+    {
+        if(ins->name() == "@param" or ins->name() == "@literal" or ins->name() == "@return")
+            continue;
+        if(starts_with(ins->name(), "@") or not ins->module_inputs().empty() or
+           ins->get_shape().dynamic() or ins->get_shape().type() == shape::tuple_type)
+            return nullopt;
+        auto op           = ins->normalized_operator();
+        bool context_free = op.is_context_free();
+        if(not context_free and not has_context)
+            return nullopt;
+        std::vector<std::size_t> inputs;
+        std::transform(ins->inputs().begin(),
+                       ins->inputs().end(),
+                       std::back_inserter(inputs),
+                       [&](instruction_ref input) { return registers.at(input); });
+        registers[ins] = p.nregisters;
+        p.steps.push_back({op, context_free, ins->get_shape().type(), inputs, p.nregisters++});
+    }
+    auto last = std::prev(m->end());
+    if(last->name() == "@return")
+        last = last->inputs().front();
+    p.result = registers.at(last);
+    return p;
+}
+
+// Copy n elements of x, starting at element i0 in the order of lens, into buffer
+static void gather(const argument& buffer,
+                   const argument& x,
+                   const std::vector<std::size_t>& lens,
+                   const std::vector<std::size_t>& strides,
+                   std::size_t i0,
+                   std::size_t n,
+                   std::vector<std::size_t>& idx)
+{
+    auto last          = lens.size() - 1;
+    std::size_t offset = 0;
+    for(std::size_t d = lens.size(); d > 0; d--)
+    {
+        idx[d - 1] = i0 % lens[d - 1];
+        i0 /= lens[d - 1];
+        offset += idx[d - 1] * strides[d - 1];
+    }
+    visit_all(buffer, x)([&](auto output, auto input) {
+        auto* dst       = output.data();
+        const auto* src = input.data();
+        for(std::size_t i = 0; i < n; i++)
+        {
+            dst[i] = src[offset];
+            offset += strides[last];
+            idx[last]++;
+            // Carry into the outer dimensions at the end of each row
+            for(auto d = last; d > 0 and idx[d] == lens[d]; d--)
+            {
+                offset -= lens[d] * strides[d];
+                idx[d] = 0;
+                idx[d - 1]++;
+                offset += strides[d - 1];
+            }
+        }
+    });
+}
+
+argument eval_pointwise(context* ctx,
+                        const shape& output_shape,
+                        const_module_ref m,
+                        const std::vector<std::string>& pnames,
+                        const std::vector<argument>& args)
+{
+    auto n = output_shape.elements();
+    if(output_shape.dynamic() or output_shape.lens().empty() or
+       not(output_shape.packed() or n == 1))
+        return {};
+    if(std::any_of(args.begin(), args.end(), [&](const auto& arg) {
+           return arg.get_shape().dynamic() or arg.get_shape().ndim() != output_shape.ndim();
+       }))
+        return {};
+    auto p = compile_pointwise(ctx != nullptr, m, pnames);
+    if(not p.has_value())
+        return {};
+    // Accessing a shared context clones it, so make sure that is done before the blocks run
+    // concurrently
+    if(ctx != nullptr)
+        ctx->get_queue();
+
+    // Iterate in the memory order of the output, so it is written contiguously, and so are the
+    // inputs that have the same layout
+    auto perm             = find_permutation(output_shape);
+    auto lens             = reorder_dims(output_shape.lens(), perm);
+    auto standard_strides = shape{output_shape.type(), lens}.strides();
+    std::vector<std::vector<std::size_t>> strides;
+    std::vector<bool> contiguous;
+    for(const auto& arg : args)
+    {
+        strides.push_back(reorder_dims(arg.get_shape().strides(), perm));
+        contiguous.push_back(n == 1 or strides.back() == standard_strides);
+    }
+
+    argument output{output_shape};
+    auto type_size = output_shape.type_size();
+    auto nparams   = args.size();
+    auto nblocks   = (n + pointwise_block_size - 1) / pointwise_block_size;
+    get_thread_pool().parallel_for(
+        nblocks, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+            // The steps allocate their results from an arena that is reset after each block, so
+            // the registers reuse the same memory instead of growing the arena of the evaluation
+            arena scratch;
+            arena_scope scope{scratch};
+            std::vector<argument> buffers(nparams);
+            for(std::size_t j = 0; j < nparams; j++)
+            {
+                if(not contiguous[j])
+                    buffers[j] =
+                        argument{shape{args[j].get_shape().type(), {pointwise_block_size}}};
+            }
+            std::vector<argument> registers(p->nregisters);
+            std::vector<argument> inputs;
+            std::vector<std::size_t> idx(lens.size());
+            for(auto block = start; block < last; block++)
+            {
+                auto i0 = block * pointwise_block_size;
+                auto bn = std::min(pointwise_block_size, n - i0);
+                for(std::size_t j = 0; j < nparams; j++)
+                {
+                    shape s{args[j].get_shape().type(), {bn}};
+                    if(contiguous[j])
+                    {
+                        registers[j] = argument{s, args[j].data() + i0 * s.type_size()};
+                        continue;
+                    }
+                    gather(buffers[j], args[j], lens, strides[j], i0, bn, idx);
+                    registers[j] = argument{s, buffers[j].data()};
+                }
+                for(std::size_t k = 0; k < p->literals.size(); k++)
+                {
+                    const auto& lit        = p->literals[k];
+                    registers[nparams + k] = argument{
+                        shape{lit.get_shape().type(), {bn}}, lit.data()};
+                }
+                for(const auto& step : p->steps)
+                {
+                    inputs.clear();
+                    std::transform(step.inputs.begin(),
+                                   step.inputs.end(),
+                                   std::back_inserter(inputs),
+                                   [&](std::size_t r) { return registers[r]; });
+                    shape s{step.type, {bn}};
+                    registers[step.output] = step.context_free
+                                                 ? step.op.compute(s, inputs)
+                                                 : step.op.compute(*ctx, s, inputs);
+                }
+                const auto& result = registers[p->result];
+                assert(result.get_shape().standard());
+                assert(result.get_shape().type() == output_shape.type());
+                std::memcpy(output.data() + i0 * type_size, result.data(), bn * type_size);
+                // Release the results of the steps so their memory is reused by the next block
+                std::fill(registers.begin() + nparams + p->literals.size(),
+                          registers.end(),
+                          argument{});
+                inputs.clear();
+                scratch.reset();
+            }
+        });
+    return output;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,254 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/execution_plan.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static execution_plan::step_kind get_step_kind(instruction_ref ins)
+{
+    const auto& name = ins->name();
+    if(name == "@literal")
+        return execution_plan::step_kind::literal;
+    if(name == "@param")
+        return execution_plan::step_kind::param;
+    if(name == "@outline")
+        return execution_plan::step_kind::outline;
+    if(name == "@return")
+        return execution_plan::step_kind::ret;
+    return execution_plan::step_kind::op;
+}
+
+// Record the order between steps of a module scheduled on several streams
+static void compute_dependencies(execution_plan::module_plan& mp)
+{
+    std::unordered_map<instruction_ref, std::size_t> ins_step;
+    std::unordered_map<std::size_t, std::size_t> last_on_stream;
+    std::unordered_map<std::size_t, std::size_t> recorded;
+    std::vector<std::vector<std::size_t>> successors(mp.steps.size());
+    std::vector<std::size_t> predecessors;
+    std::size_t stream = 0;
+    for(auto i : range(mp.steps.size()))
+    {
+        auto& s = mp.steps[i];
+        // The return is evaluated after all the other steps
+        if(s.kind == execution_plan::step_kind::ret)
+            continue;
+        ins_step[s.ins] = i;
+        predecessors.clear();
+        std::size_t wait_id = mp.steps.size();
+        if(s.kind == execution_plan::step_kind::op)
+        {
+            auto attr = s.op.attributes();
+            stream    = attr.get("set_stream", stream);
+            wait_id   = attr.get("wait_event", wait_id);
+            if(attr.contains("record_event"))
+                recorded[attr.at("record_event").to<std::size_t>()] = i;
+        }
+        if(contains(last_on_stream, stream))
+            predecessors.push_back(last_on_stream.at(stream));
+        last_on_stream[stream] = i;
+        if(contains(recorded, wait_id))
+            predecessors.push_back(recorded.at(wait_id));
+        for(auto input : s.ins->inputs())
+        {
+            if(contains(ins_step, input))
+                predecessors.push_back(ins_step.at(input));
+        }
+        std::sort(predecessors.begin(), predecessors.end());
+        predecessors.erase(std::unique(predecessors.begin(), predecessors.end()),
+                           predecessors.end());
+        s.npredecessors = predecessors.size();
+        for(auto p : predecessors)
+            successors[p].push_back(i);
+    }
+    mp.streams = last_on_stream.size();
+    for(auto i : range(mp.steps.size()))
+    {
+        auto& s           = mp.steps[i];
+        s.first_successor = mp.successors.size();
+        s.nsuccessors     = successors[i].size();
+        mp.successors.insert(mp.successors.end(), successors[i].begin(), successors[i].end());
+    }
+}
+
+// Allocations that can be replaced by a buffer of the same size without changing the result
+static bool is_allocation(instruction_ref ins)
+{
+    return ins->name() == "load" or ends_with(ins->name(), "allocate");
+}
+
+// Find the allocations the outputs of the main module are written to
+static void find_output_buffers(execution_plan::module_plan& mp, std::vector<std::size_t>& result)
+{
+    if(mp.steps.empty())
+        return;
+    const auto& last = mp.steps.back();
+    std::vector<instruction_ref> outputs;
+    if(last.kind == execution_plan::step_kind::ret)
+        outputs = last.ins->inputs();
+    else
+        outputs = {last.ins};
+    std::unordered_map<instruction_ref, std::size_t> ins_step;
+    for(auto i : range(mp.steps.size()))
+        ins_step[mp.steps[i].ins] = i;
+    std::vector<instruction_ref> allocations(outputs.size());
+    std::transform(outputs.begin(), outputs.end(), allocations.begin(), [](instruction_ref ins) {
+        return instruction::get_output_alias(ins);
+    });
+    result.resize(outputs.size(), mp.steps.size());
+    for(auto i : range(outputs.size()))
+    {
+        auto alloc = allocations[i];
+        if(not is_allocation(alloc) or not contains(ins_step, alloc))
+            continue;
+        const auto& s       = outputs[i]->get_shape();
+        const auto& alloc_s = alloc->get_shape();
+        if(s.dynamic() or alloc_s.dynamic())
+            continue;
+        if(not s.standard() or not alloc_s.standard() or s.bytes() != alloc_s.bytes())
+            continue;
+        // Outputs sharing a buffer can not be bound to different buffers
+        if(std::count(allocations.begin(), allocations.end(), alloc) != 1)
+            continue;
+        result[i] = ins_step.at(alloc);
+        mp.steps[result[i]].output_buffer = true;
+    }
+}
+
+static bool is_scheduled(const execution_plan::module_plan& mp)
+{
+    return std::any_of(mp.steps.begin(), mp.steps.end(), [](const execution_plan::step& s) {
+        return s.kind == execution_plan::step_kind::op and
+               s.op.attributes().contains("set_stream");
+    });
+}
+
+execution_plan::execution_plan(const_module_ref mm)
+{
+    std::vector<const_module_ref> mods = {mm};
+    for(auto* smod : mm->get_sub_modules())
+    {
+        if(not contains(mods, smod))
+            mods.push_back(smod);
+    }
+
+    modules.resize(mods.size());
+    std::unordered_map<const_module_ref, std::size_t> mod_index;
+    std::unordered_map<instruction_ref, std::size_t> ins_slot;
+    for(auto i : range(mods.size()))
+    {
+        mod_index[mods[i]]    = i;
+        modules[i].first_slot = slots;
+        for(auto ins : iterator_for(*mods[i]))
+            ins_slot[ins] = slots++;
+        modules[i].nslots = slots - modules[i].first_slot;
+    }
+
+    for(auto i : range(mods.size()))
+    {
+        auto& mp   = modules[i];
+        mp.mod     = mods[i];
+        mp.version = mp.mod->get_version();
+        mp.steps.reserve(mods[i]->size());
+        for(auto ins : iterator_for(*mp.mod))
+        {
+            step s;
+            s.kind        = get_step_kind(ins);
+            s.ins         = ins;
+            s.output      = ins_slot.at(ins);
+            s.first_input = mp.inputs.size();
+            s.ninputs     = ins->inputs().size();
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(mp.inputs),
+                           [&](instruction_ref input) {
+                               if(not contains(ins_slot, input))
+                                   MIGRAPHX_THROW("Input of " + ins->name() +
+                                                  " is not part of the program");
+                               return ins_slot.at(input);
+                           });
+            if(s.kind == step_kind::op)
+            {
+                // The normalization only depends on the shapes of the instructions, which don't
+                // change between evaluations even when they are dynamic
+                s.op           = ins->normalized_operator();
+                s.context_free = s.op.is_context_free();
+            }
+            if(s.kind == step_kind::param)
+            {
+                s.index = mp.params.size();
+                mp.params.push_back(any_cast<builtin::param>(ins->get_operator()).parameter);
+            }
+            else
+            {
+                s.index = mp.sub_plans.size();
+                std::transform(ins->module_inputs().begin(),
+                               ins->module_inputs().end(),
+                               std::back_inserter(mp.sub_plans),
+                               [&](const_module_ref smod) { return mod_index.at(smod); });
+            }
+            max_inputs = std::max(max_inputs, s.ninputs);
+            mp.steps.push_back(s);
+        }
+        if(is_scheduled(mp))
+            compute_dependencies(mp);
+    }
+    find_output_buffers(modules.front(), output_steps);
+}
+
+bool execution_plan::is_stale() const
+{
+    return std::any_of(modules.begin(), modules.end(), [](const module_plan& mp) {
+        return mp.version != mp.mod->get_version();
+    });
+}
+
+std::size_t execution_plan::get_sub_plan(const module_plan& mp,
+                                         const step& s,
+                                         const_module_ref smod) const
+{
+    const auto& mod_args = s.ins->module_inputs();
+    auto it              = std::find(mod_args.begin(), mod_args.end(), smod);
+    if(it != mod_args.end())
+        return mp.sub_plans[s.index + std::distance(mod_args.begin(), it)];
+    // The module was not passed to the instruction, so search the whole plan
+    auto mit = std::find_if(modules.begin(), modules.end(), [&](const module_plan& p) {
+        return p.mod == smod;
+    });
+    if(mit == modules.end())
+        MIGRAPHX_THROW("Module " + smod->name() + " is not part of the execution plan");
+    return std::distance(modules.begin(), mit);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
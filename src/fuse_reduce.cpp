@@ -78,6 +78,41 @@ struct fused_reduce
             sm->get_output_shapes().front().type(), lens, find_permutation(inputs));
     }
 
+    // Evaluate the submodule, where the reductions use the reduction engine of the reduce ops
+    argument compute(const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const std::function<std::vector<argument>(
+                         module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+    {
+        auto* sm    = mods.front();
+        auto names  = sm->get_parameter_names();
+        auto shapes = sm->get_parameter_shapes();
+        std::sort(names.begin(), names.end());
+        // Copy the arguments into the layout of the parameters, and the result into the layout
+        // of the output
+        auto relayout = [](const shape& s, const argument& arg) {
+            if(arg.get_shape() == s)
+                return arg;
+            argument result{s};
+            visit_all(result, arg)([&](auto output, auto input) {
+                std::copy(input.begin(), input.end(), output.begin());
+            });
+            return result;
+        };
+        std::unordered_map<std::string, argument> params;
+        std::transform(names.begin(),
+                       names.end(),
+                       args.begin(),
+                       std::inserter(params, params.end()),
+                       [&](const auto& name, const auto& arg) {
+                           return std::make_pair(name, relayout(shapes.at(name), arg));
+                       });
+        auto results = run(sm, params);
+        assert(results.size() == 1);
+        return relayout(output_shape, results.front());
+    }
+
     std::string name() const { return "fused_reduce"; }
 };
 MIGRAPHX_REGISTER_OP(fused_reduce);
@@ -0,0 +1,108 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_ARENA_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_ARENA_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <iosfwd>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct arena_impl;
+
+struct MIGRAPHX_EXPORT arena_stats
+{
+    // Number of allocations made from the arena
+    std::size_t allocations = 0;
+    // Number of blocks allocated from the system
+    std::size_t blocks = 0;
+    // Largest number of bytes allocated during one evaluation
+    std::size_t high_water = 0;
+    // Bytes currently held by the arena
+    std::size_t capacity = 0;
+
+    friend MIGRAPHX_EXPORT std::ostream& operator<<(std::ostream& os, const arena_stats& s);
+};
+
+/**
+ * @brief A bump allocator for the buffers created while evaluating a program
+ *
+ * Allocations are carved out of large blocks, aligned to 64 bytes. The arena is reset before each
+ * evaluation, which moves it to a block sized to the largest evaluation seen so far. After the
+ * first run an allocation is a pointer bump into memory that has already been touched.
+ *
+ * Arguments keep their block alive, and a block is only reused once none of the arguments
+ * allocated from it are alive. The results of an evaluation are detached from the arena when it
+ * ends, so a small result kept by the caller does not pin a whole block.
+ */
+struct MIGRAPHX_EXPORT arena
+{
+    static constexpr std::size_t alignment = 64;
+
+    arena();
+    arena(const arena&)            = delete;
+    arena& operator=(const arena&) = delete;
+    ~arena();
+
+    /// Allocate uninitialized memory
+    std::shared_ptr<char> allocate(std::size_t bytes);
+
+    /// Allocate an uninitialized argument
+    argument allocate(const shape& s);
+
+    /// Start a new evaluation, the blocks that are no longer used can be allocated from again
+    void reset();
+
+    /// Copy the argument out of the arena when it was allocated from it
+    argument detach(const argument& a) const;
+
+    arena_stats get_stats() const;
+    void reset_stats();
+
+    /// The arena that `argument{shape}` allocates from on the calling thread, or null
+    static arena* current();
+
+    private:
+    std::unique_ptr<arena_impl> impl;
+};
+
+/// Makes `argument{shape}` allocate from the arena on the calling thread while it is alive
+struct MIGRAPHX_EXPORT arena_scope
+{
+    explicit arena_scope(arena& a);
+    arena_scope(const arena_scope&)            = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+    ~arena_scope();
+
+    private:
+    arena* previous = nullptr;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/tracer.hpp>
+#include <string>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -41,6 +42,13 @@ struct compile_options
     bool fast_math       = true;
     bool exhaustive_tune = false;
 
+    /**
+     * How fp16 is computed. "native" uses fp16 arithmetic where the target has it and float
+     * elsewhere, "storage" keeps the fp16 data but converts it to float around every operator
+     * that computes, and "float" converts the whole program to float.
+     */
+    std::string fp16_mode = "native";
+
     tracer trace{};
 };
 
@@ -33,6 +33,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/any_ptr.hpp>
+#include <migraphx/argument.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -44,6 +45,13 @@ inline namespace MIGRAPHX_INLINE_NS {
 /// during `eval`.
 struct context
 {
+    /// Called before the program is evaluated, so the memory allocated by the previous
+    /// evaluation can be reused. It does not modify the context, so a context shared with the
+    /// target is not copied.
+    void reset_memory() const;
+    /// Called with each result of the evaluation, and returns a copy of it when it is in memory
+    /// that the next evaluation reuses
+    argument detach_memory(const argument& result) const;
     /// Wait for any tasks in the context to complete
     void finish() const;
 };
@@ -77,6 +85,17 @@ void finish_on_context(T&, any_ptr)
 {
 }
 
+template <class T>
+void reset_memory_context(const T&)
+{
+}
+
+template <class T>
+argument detach_memory_context(const T&, const argument& result)
+{
+    return result;
+}
+
 #ifdef TYPE_ERASED_DECLARATION
 
 // Type-erased interface for:
@@ -92,6 +111,10 @@ struct MIGRAPHX_EXPORT context
     void wait_for(any_ptr queue);
     // (optional)
     void finish_on(any_ptr queue);
+    // (optional)
+    void reset_memory() const;
+    // (optional)
+    argument detach_memory(const argument& result) const;
     //
     void finish() const;
 };
@@ -191,6 +214,18 @@ struct context
         (*this).private_detail_te_get_handle().finish_on(queue);
     }
 
+    void reset_memory() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        (*this).private_detail_te_get_handle().reset_memory();
+    }
+
+    argument detach_memory(const argument& result) const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().detach_memory(result);
+    }
+
     void finish() const
     {
         assert((*this).private_detail_te_handle_mem_var);
@@ -210,12 +245,14 @@ struct context
         virtual std::shared_ptr<private_detail_te_handle_base_type> clone() const = 0;
         virtual const std::type_info& type() const                                = 0;
 
-        virtual value to_value() const          = 0;
-        virtual void from_value(const value& v) = 0;
-        virtual any_ptr get_queue()             = 0;
-        virtual void wait_for(any_ptr queue)    = 0;
-        virtual void finish_on(any_ptr queue)   = 0;
-        virtual void finish() const             = 0;
+        virtual value to_value() const                               = 0;
+        virtual void from_value(const value& v)                      = 0;
+        virtual any_ptr get_queue()                                  = 0;
+        virtual void wait_for(any_ptr queue)                         = 0;
+        virtual void finish_on(any_ptr queue)                        = 0;
+        virtual void reset_memory() const                            = 0;
+        virtual argument detach_memory(const argument& result) const = 0;
+        virtual void finish() const                                  = 0;
     };
 
     template <class T>
@@ -286,6 +323,36 @@ struct context
         finish_on_context(private_detail_te_self, queue);
     }
 
+    template <class T>
+    static auto private_detail_te_default_reset_memory(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.reset_memory())
+    {
+        private_detail_te_self.reset_memory();
+    }
+
+    template <class T>
+    static void private_detail_te_default_reset_memory(float, T&& private_detail_te_self)
+    {
+        reset_memory_context(private_detail_te_self);
+    }
+
+    template <class T>
+    static auto private_detail_te_default_detach_memory(char,
+                                                        T&& private_detail_te_self,
+                                                        const argument& result)
+        -> decltype(private_detail_te_self.detach_memory(result))
+    {
+        return private_detail_te_self.detach_memory(result);
+    }
+
+    template <class T>
+    static argument private_detail_te_default_detach_memory(float,
+                                                            T&& private_detail_te_self,
+                                                            const argument& result)
+    {
+        return detach_memory_context(private_detail_te_self, result);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -344,6 +411,19 @@ struct context
             private_detail_te_default_finish_on(char(0), private_detail_te_value, queue);
         }
 
+        void reset_memory() const override
+        {
+
+            private_detail_te_default_reset_memory(char(0), private_detail_te_value);
+        }
+
+        argument detach_memory(const argument& result) const override
+        {
+
+            return private_detail_te_default_detach_memory(
+                char(0), private_detail_te_value, result);
+        }
+
         void finish() const override { private_detail_te_value.finish(); }
 
         PrivateDetailTypeErasedT private_detail_te_value;
@@ -25,75 +25,422 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONVOLUTION_HPP
 
 #include <migraphx/config.hpp>
-#include <migraphx/dfor.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/gemm.hpp>
+#include <migraphx/par.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <type_traits>
 #include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class Output, class T, class Padding, class Stride, class Dilation>
-void convolution(
-    Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
+namespace detail {
+
+// The columns of im2col are split into chunks so the column buffer of a task stays in cache
+constexpr std::size_t conv_col_elements = 64 * 1024;
+constexpr std::size_t conv_min_chunk    = 64;
+
+// The spatial dimensions of a convolution, where output position j reads the input at
+// j * stride - padding + tap * dilation in each dimension
+struct conv_geometry
 {
-    auto output_shape = output.get_shape();
-    auto in_lens      = input.get_shape().lens();
+    std::vector<std::size_t> in_lens;
+    std::vector<std::size_t> in_strides;
+    std::vector<std::size_t> out_lens;
+    std::vector<std::size_t> kernel;
+    std::vector<std::ptrdiff_t> padding;
+    std::vector<std::ptrdiff_t> stride;
+    std::vector<std::ptrdiff_t> dilation;
 
-    auto wei_lens = weights.get_shape().lens();
-    auto wei_n    = wei_lens[0];
-    auto wei_c    = wei_lens[1];
-    std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+    std::size_t out_elements() const
+    {
+        return std::accumulate(
+            out_lens.begin(), out_lens.end(), std::size_t{1}, std::multiplies<>{});
+    }
 
-    par_for(output_shape.elements(), [&](auto i) {
-        auto idx_o = output_shape.multi(i);
-        auto w     = idx_o[1];
-        auto n_dim = idx_o.size();
+    std::size_t kernel_elements() const
+    {
+        return std::accumulate(kernel.begin(), kernel.end(), std::size_t{1}, std::multiplies<>{});
+    }
 
-        std::vector<std::ptrdiff_t> win_start;
-        for(std::size_t dim = 2; dim < n_dim; ++dim)
+    // Call f(j, offset, inside) for the output positions in [j0, j1) at one tap of the kernel.
+    // The offset is relative to the start of the input channel, and is only valid when inside
+    // is true, otherwise the position reads the padding.
+    template <class F>
+    void for_each_position(std::size_t tap, std::size_t j0, std::size_t j1, F f) const
+    {
+        auto ndim = out_lens.size();
+        assert(ndim > 0);
+        auto last = ndim - 1;
+        std::vector<std::ptrdiff_t> shift(ndim);
+        for(std::size_t d = ndim; d > 0; d--)
         {
-            auto d_2 = dim - 2;
-            win_start.push_back(std::ptrdiff_t(idx_o[dim] * stride[d_2]) -
-                                std::ptrdiff_t(padding[d_2]));
+            shift[d - 1] = std::ptrdiff_t(tap % kernel[d - 1]) * dilation[d - 1] - padding[d - 1];
+            tap /= kernel[d - 1];
         }
-        const auto group_id = w / (wei_n / group);
-
-        shape win_shape{output_shape.type(), win_size};
-
-        double acc = 0.0;
-        shape_for_each(win_shape, [&](const auto& idx_win) {
-            auto k           = idx_win[0];
-            const auto in_ch = group_id * wei_c + k;
-            std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-            idx[1] = in_ch;
-            std::vector<std::ptrdiff_t> idx_dil(idx_win.size() - 1);
-            std::transform(idx_win.cbegin() + 1,
-                           idx_win.cend(),
-                           dilation.cbegin(),
-                           idx_dil.begin(),
-                           [](std::ptrdiff_t ii, std::ptrdiff_t d) { return d * ii; });
-            std::transform(idx_dil.begin(),
-                           idx_dil.end(),
-                           win_start.begin(),
-                           idx.begin() + 2,
-                           [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-            std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-            idx_wei[0] = w;
-            std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-            if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-               std::equal(idx.begin(),
-                          idx.end(),
-                          in_lens.begin(),
-                          in_lens.end(),
-                          std::less<std::ptrdiff_t>{}))
+        std::vector<std::size_t> pos(ndim);
+        auto j = j0;
+        while(j < j1)
+        {
+            auto r = j;
+            for(std::size_t d = ndim; d > 0; d--)
             {
-                acc += input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
+                pos[d - 1] = r % out_lens[d - 1];
+                r /= out_lens[d - 1];
             }
+            // The outer dimensions are the same along the row of the last dimension
+            std::ptrdiff_t base = 0;
+            bool row_inside     = true;
+            for(std::size_t d = 0; d < last; d++)
+            {
+                auto x = std::ptrdiff_t(pos[d]) * stride[d] + shift[d];
+                row_inside = row_inside and x >= 0 and x < std::ptrdiff_t(in_lens[d]);
+                base += x * std::ptrdiff_t(in_strides[d]);
+            }
+            auto n = std::min(j1 - j, out_lens[last] - pos[last]);
+            for(auto p = pos[last]; p < pos[last] + n; p++, j++)
+            {
+                auto x      = std::ptrdiff_t(p) * stride[last] + shift[last];
+                bool inside = row_inside and x >= 0 and x < std::ptrdiff_t(in_lens[last]);
+                f(j, inside ? std::size_t(base + x * std::ptrdiff_t(in_strides[last])) : 0, inside);
+            }
+        }
+    }
+};
+
+template <class Padding, class Stride, class Dilation>
+conv_geometry make_conv_geometry(const shape& in_shape,
+                                 const shape& out_shape,
+                                 const shape& wei_shape,
+                                 const Padding& padding,
+                                 const Stride& stride,
+                                 const Dilation& dilation)
+{
+    conv_geometry g;
+    auto ndim = in_shape.ndim() - 2;
+    g.in_lens.assign(in_shape.lens().begin() + 2, in_shape.lens().end());
+    g.in_strides.assign(in_shape.strides().begin() + 2, in_shape.strides().end());
+    g.out_lens.assign(out_shape.lens().begin() + 2, out_shape.lens().end());
+    g.kernel.assign(wei_shape.lens().begin() + 2, wei_shape.lens().end());
+    // Only the padding at the start of each dimension is needed
+    g.padding.assign(padding.begin(), padding.begin() + ndim);
+    g.stride.assign(stride.begin(), stride.begin() + ndim);
+    g.dilation.assign(dilation.begin(), dilation.begin() + ndim);
+    return g;
+}
+
+// The accumulator of the direct kernels, which follows the accumulation of gemm
+template <class T, class F>
+void visit_conv_accumulator(F f)
+{
+    if(gemm_double_accumulation())
+        f(double{});
+    else
+        f(gemm_accumulator<std::remove_cv_t<T>>{});
+}
+
+template <class T>
+shape standard_shape(tensor_view<T> x)
+{
+    return {x.get_shape().type(), x.get_shape().lens()};
+}
+
+// Calls f(offset, standard_offset) for every element of x, where standard_offset is the offset
+// of the element in the standard layout of x
+template <class T, class F>
+void standard_for_each(tensor_view<T> x, F f)
+{
+    const auto& s = x.get_shape();
+    par_strided_for_each(s.lens(),
+                         std::array{s.strides(), standard_shape(x).strides()},
+                         par_transform_min_grain,
+                         [&](const auto& offsets) { f(offsets[0], offsets[1]); });
+}
+
+template <class T>
+std::vector<std::remove_cv_t<T>> standard_copy(tensor_view<T> x)
+{
+    std::vector<std::remove_cv_t<T>> result(x.get_shape().elements());
+    standard_for_each(x, [&](auto i, auto j) { result[j] = x.data()[i]; });
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * Computes a grouped convolution of input [N, C, spatial...] with weights [K, C / group,
+ * kernel...] into output [N, K, spatial...].
+ *
+ * The general case is an im2col followed by a gemm for each batch and group, where the columns
+ * are split into chunks that fit in cache. A 1x1 convolution with unit stride multiplies the
+ * input directly, and a depthwise convolution accumulates each tap of the kernel over the whole
+ * channel.
+ */
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution(
+    Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
+{
+    using type     = std::remove_cv_t<typename T::value_type>;
+    using out_type = std::remove_cv_t<typename Output::value_type>;
+    if(not output.get_shape().standard())
+    {
+        std::vector<out_type> buffer(output.get_shape().elements());
+        convolution(make_view(detail::standard_shape(output), buffer.data()),
+                    input,
+                    weights,
+                    padding,
+                    stride,
+                    dilation,
+                    group);
+        detail::standard_for_each(output, [&](auto i, auto j) { output.data()[i] = buffer[j]; });
+        return;
+    }
+    if(not weights.get_shape().standard())
+    {
+        auto wbuffer = detail::standard_copy(weights);
+        convolution(output,
+                    input,
+                    make_view(detail::standard_shape(weights), wbuffer.data()),
+                    padding,
+                    stride,
+                    dilation,
+                    group);
+        return;
+    }
+    const auto& in_s  = input.get_shape();
+    const auto& out_s = output.get_shape();
+    const auto& wei_s = weights.get_shape();
+    auto geom = detail::make_conv_geometry(in_s, out_s, wei_s, padding, stride, dilation);
+
+    std::size_t ngroups = group;
+    auto batch          = out_s.lens()[0];
+    auto kg             = wei_s.lens()[0] / ngroups;
+    auto cg             = wei_s.lens()[1];
+    auto ks             = geom.kernel_elements();
+    auto os             = geom.out_elements();
+    auto in_n_stride    = in_s.strides()[0];
+    auto in_c_stride    = in_s.strides()[1];
+    auto out_n_stride   = out_s.strides()[0];
+    auto out_c_stride   = out_s.strides()[1];
+    auto* in_data       = input.data();
+    auto* wei_data      = weights.data();
+    auto* out_data      = output.data();
+
+    // The filters of one group as a kg x (cg * ks) matrix
+    auto filters = [&](std::size_t g) {
+        return make_view(shape{wei_s.type(), {kg, cg * ks}}, wei_data + g * kg * cg * ks);
+    };
+    auto outputs = [&](std::size_t n, std::size_t g, std::size_t j0, std::size_t cols) {
+        return make_view(shape{out_s.type(), {kg, cols}, {out_c_stride, 1}},
+                         out_data + n * out_n_stride + g * kg * out_c_stride + j0);
+    };
+
+    bool depthwise = cg == 1 and kg == 1;
+    bool pointwise = std::all_of(geom.kernel.begin(), geom.kernel.end(), [](auto k) {
+        return k == 1;
+    }) and std::all_of(geom.stride.begin(), geom.stride.end(), [](auto s) {
+        return s == 1;
+    }) and std::all_of(geom.padding.begin(), geom.padding.end(), [](auto p) {
+        return p == 0;
+    }) and geom.in_lens == geom.out_lens and in_s.standard();
+
+    if(depthwise)
+    {
+        detail::visit_conv_accumulator<type>([&](auto acc_zero) {
+            using acc_type = decltype(acc_zero);
+            get_thread_pool().parallel_for(
+                batch * ngroups, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+                    std::vector<acc_type> acc(os);
+                    for(auto task = start; task < last; task++)
+                    {
+                        auto n   = task / ngroups;
+                        auto c   = task % ngroups;
+                        auto* x  = in_data + n * in_n_stride + c * in_c_stride;
+                        auto* w  = wei_data + c * ks;
+                        auto* y  = out_data + n * out_n_stride + c * out_c_stride;
+                        std::fill(acc.begin(), acc.end(), acc_type{0});
+                        for(std::size_t tap = 0; tap < ks; tap++)
+                        {
+                            auto wt = static_cast<acc_type>(w[tap]);
+                            geom.for_each_position(
+                                tap, 0, os, [&](std::size_t j, std::size_t offset, bool inside) {
+                                    if(inside)
+                                        acc[j] += wt * static_cast<acc_type>(x[offset]);
+                                });
+                        }
+                        std::transform(acc.begin(), acc.end(), y, [](auto a) {
+                            return static_cast<out_type>(a);
+                        });
+                    }
+                });
         });
+    }
+    else if(pointwise)
+    {
+        get_thread_pool().parallel_for(
+            batch * ngroups, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+                for(auto task = start; task < last; task++)
+                {
+                    auto n = task / ngroups;
+                    auto g = task % ngroups;
+                    auto x = make_view(shape{in_s.type(), {cg, os}, {in_c_stride, 1}},
+                                       in_data + n * in_n_stride + g * cg * in_c_stride);
+                    gemm(outputs(n, g, 0, os), filters(g), x, 1, 0);
+                }
+            });
+    }
+    else
+    {
+        auto rows = cg * ks;
+        auto chunk =
+            std::min(os, std::max(detail::conv_min_chunk, detail::conv_col_elements / rows));
+        auto chunks = (os + chunk - 1) / chunk;
+        get_thread_pool().parallel_for(
+            batch * ngroups * chunks, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+                std::vector<type> col(rows * chunk);
+                for(auto task = start; task < last; task++)
+                {
+                    auto n    = task / (ngroups * chunks);
+                    auto g    = task / chunks % ngroups;
+                    auto j0   = task % chunks * chunk;
+                    auto cols = std::min(chunk, os - j0);
+                    for(std::size_t c = 0; c < cg; c++)
+                    {
+                        auto* x = in_data + n * in_n_stride + (g * cg + c) * in_c_stride;
+                        for(std::size_t tap = 0; tap < ks; tap++)
+                        {
+                            auto* row = col.data() + (c * ks + tap) * cols;
+                            geom.for_each_position(
+                                tap,
+                                j0,
+                                j0 + cols,
+                                [&](std::size_t j, std::size_t offset, bool inside) {
+                                    row[j - j0] = inside ? x[offset] : type{0};
+                                });
+                        }
+                    }
+                    auto xcol = make_view(shape{in_s.type(), {rows, cols}}, col.data());
+                    gemm(outputs(n, g, j0, cols), filters(g), xcol, 1, 0);
+                }
+            });
+    }
+}
+
+/**
+ * Computes the transposed convolution of input [N, C, spatial...] with weights [C, K / group,
+ * kernel...] into output [N, K, spatial...].
+ *
+ * For each batch and group the product of the transposed filters with the input is a column
+ * buffer like the one of im2col, which is then scattered and added into the output (col2im).
+ */
+template <class Output, class T, class Padding, class Stride, class Dilation>
+void convolution_backwards(
+    Output output, T input, T weights, Padding padding, Stride stride, Dilation dilation, int group)
+{
+    using type     = std::remove_cv_t<typename T::value_type>;
+    using out_type = std::remove_cv_t<typename Output::value_type>;
+    if(not output.get_shape().standard())
+    {
+        std::vector<out_type> buffer(output.get_shape().elements());
+        convolution_backwards(make_view(detail::standard_shape(output), buffer.data()),
+                              input,
+                              weights,
+                              padding,
+                              stride,
+                              dilation,
+                              group);
+        detail::standard_for_each(output, [&](auto i, auto j) { output.data()[i] = buffer[j]; });
+        return;
+    }
+    if(not input.get_shape().standard() or not weights.get_shape().standard())
+    {
+        auto xbuffer = detail::standard_copy(input);
+        auto wbuffer = detail::standard_copy(weights);
+        convolution_backwards(output,
+                              make_view(detail::standard_shape(input), xbuffer.data()),
+                              make_view(detail::standard_shape(weights), wbuffer.data()),
+                              padding,
+                              stride,
+                              dilation,
+                              group);
+        return;
+    }
+    const auto& in_s  = input.get_shape();
+    const auto& out_s = output.get_shape();
+    const auto& wei_s = weights.get_shape();
+    // Each input position scatters into the output, so the geometry goes from the input to the
+    // output
+    auto geom = detail::make_conv_geometry(out_s, in_s, wei_s, padding, stride, dilation);
+
+    std::size_t ngroups = group;
+    auto batch          = in_s.lens()[0];
+    auto cg             = wei_s.lens()[0] / ngroups;
+    auto kg             = wei_s.lens()[1];
+    auto ks             = geom.kernel_elements();
+    auto is             = geom.out_elements();
+    auto os             = out_s.elements() / (out_s.lens()[0] * out_s.lens()[1]);
+    auto rows           = kg * ks;
+    auto chunk = std::min(is, std::max(detail::conv_min_chunk, detail::conv_col_elements / rows));
+
+    auto* in_data  = input.data();
+    auto* wei_data = weights.data();
+    auto* out_data = output.data();
 
-        output[i] = acc;
+    detail::visit_conv_accumulator<type>([&](auto acc_zero) {
+        using acc_type = decltype(acc_zero);
+        get_thread_pool().parallel_for(
+            batch * ngroups, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+                std::vector<acc_type> col(rows * chunk);
+                std::vector<acc_type> acc(kg * os);
+                for(auto task = start; task < last; task++)
+                {
+                    auto n = task / ngroups;
+                    auto g = task % ngroups;
+                    std::fill(acc.begin(), acc.end(), acc_type{0});
+                    // The filters of the group transposed to (kg * ks) x cg
+                    auto filters = make_view(shape{wei_s.type(), {rows, cg}, {1, rows}},
+                                             wei_data + g * cg * rows);
+                    for(std::size_t i0 = 0; i0 < is; i0 += chunk)
+                    {
+                        auto cols = std::min(chunk, is - i0);
+                        auto x    = make_view(shape{in_s.type(), {cg, cols}, {is, 1}},
+                                           in_data + (n * ngroups + g) * cg * is + i0);
+                        gemm(make_view(shape{shape::get_type<acc_type>{}, {rows, cols}},
+                                       col.data()),
+                             filters,
+                             x,
+                             1,
+                             0);
+                        for(std::size_t k = 0; k < kg; k++)
+                        {
+                            auto* y = acc.data() + k * os;
+                            for(std::size_t tap = 0; tap < ks; tap++)
+                            {
+                                const auto* row = col.data() + (k * ks + tap) * cols;
+                                geom.for_each_position(
+                                    tap,
+                                    i0,
+                                    i0 + cols,
+                                    [&](std::size_t i, std::size_t offset, bool inside) {
+                                        if(inside)
+                                            y[offset] += row[i - i0];
+                                    });
+                            }
+                        }
+                    }
+                    std::transform(acc.begin(),
+                                   acc.end(),
+                                   out_data + (n * ngroups + g) * kg * os,
+                                   [](auto a) { return static_cast<out_type>(a); });
+                }
+            });
     });
 }
 
@@ -0,0 +1,60 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_EVAL_POINTWISE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_EVAL_POINTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/module_ref.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct context;
+
+/**
+ * Evaluates the pointwise module m over whole tensors, where args are bound to the parameters in
+ * the order of pnames.
+ *
+ * The module is compiled once into a list of steps over registers. The elements are processed in
+ * blocks in the memory order of the output: each register holds a block, the inputs are gathered
+ * into their registers with their strides, so broadcasted inputs are read in place, and every
+ * operator is computed over the whole block. The blocks are spread across the thread pool.
+ *
+ * The operators that need a context are computed with ctx. Returns an empty argument when the
+ * module can not be evaluated this way, such as when an operator has a submodule, or needs a
+ * context and ctx is null.
+ */
+MIGRAPHX_EXPORT argument eval_pointwise(context* ctx,
+                                        const shape& output_shape,
+                                        const_module_ref m,
+                                        const std::vector<std::string>& pnames,
+                                        const std::vector<argument>& args);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -29,10 +29,14 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+struct timeline;
+
 struct execution_environment
 {
     any_ptr queue = any_ptr{};
     bool async    = false;
+    // Records when each instruction runs, when set
+    timeline* trace = nullptr;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
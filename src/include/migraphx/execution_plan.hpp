@@ -0,0 +1,136 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_EXECUTION_PLAN_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_EXECUTION_PLAN_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/module_ref.hpp>
+#include <migraphx/operation.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/**
+ * @brief A module lowered to a flat list of steps for evaluation
+ *
+ * Every instruction of the main module and its submodules is assigned an integer slot, so that
+ * evaluation can store results in a contiguous vector instead of a map keyed on instructions.
+ * Builtin instructions are classified once so the evaluator does not need to compare names, and
+ * the normalized operator of every other instruction is stored with its step.
+ *
+ * When a module has been scheduled on several streams with operators that report the
+ * `set_stream`, `record_event` and `wait_event` attributes, the dependencies between the steps are
+ * also recorded. Steps on the same stream run in order, and a step waiting for an event runs
+ * after the step that records it, which is what the memory conflicts from the schedule pass
+ * assume.
+ */
+struct MIGRAPHX_EXPORT execution_plan
+{
+    enum class step_kind
+    {
+        literal,
+        param,
+        outline,
+        ret,
+        op
+    };
+
+    struct step
+    {
+        step_kind kind = step_kind::op;
+        instruction_ref ins;
+        // The operator normalized against the input shapes, resolved once after finalize so
+        // evaluation doesn't copy and normalize it again
+        operation op;
+        bool context_free = false;
+        // The step allocates the buffer an output of the program is written to, and is skipped
+        // when the slot already holds a buffer bound by the caller
+        bool output_buffer = false;
+        // Slot where the result of the instruction is stored
+        std::size_t output = 0;
+        // Range of the input slots in module_plan::inputs
+        std::size_t first_input = 0;
+        std::size_t ninputs     = 0;
+        // Index into module_plan::params for parameters, or the first index into
+        // module_plan::sub_plans for instructions with module inputs
+        std::size_t index = 0;
+        // Range of the dependent steps in module_plan::successors, and the number of steps this
+        // one depends on. These are only set when the module is scheduled on several streams.
+        std::size_t first_successor = 0;
+        std::size_t nsuccessors     = 0;
+        std::size_t npredecessors   = 0;
+    };
+
+    struct module_plan
+    {
+        const_module_ref mod = nullptr;
+        // The slots of the instructions of the module are [first_slot, first_slot + nslots). Each
+        // evaluation of a submodule stores them separately.
+        std::size_t first_slot = 0;
+        std::size_t nslots     = 0;
+        std::vector<step> steps;
+        std::vector<std::size_t> inputs;
+        std::vector<std::size_t> sub_plans;
+        std::vector<std::string> params;
+        // Value of module::get_version() when the plan was built
+        std::size_t version = 0;
+        // Number of streams the module was scheduled on
+        std::size_t streams = 1;
+        std::vector<std::size_t> successors;
+
+        /// Returns true if the steps can be evaluated concurrently
+        bool is_concurrent() const { return streams > 1; }
+    };
+
+    execution_plan() = default;
+    explicit execution_plan(const_module_ref mm);
+
+    /// Returns true if an instruction of one of the modules was modified after the plan was built
+    bool is_stale() const;
+
+    bool empty() const { return modules.empty(); }
+
+    /// Find the plan of a submodule used by the step
+    std::size_t get_sub_plan(const module_plan& mp, const step& s, const_module_ref smod) const;
+
+    // The first plan is always for the main module
+    std::vector<module_plan> modules;
+    // Total number of result slots
+    std::size_t slots = 0;
+    // Largest number of inputs of any step
+    std::size_t max_inputs = 0;
+    // For each output of the main module, the index of the step allocating its buffer, or
+    // steps.size() when the output can not be written to a buffer from the caller
+    std::vector<std::size_t> output_steps;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
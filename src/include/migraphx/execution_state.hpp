@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_EXECUTION_STATE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_EXECUTION_STATE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/execution_environment.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct program;
+struct execution_state_impl;
+
+/**
+ * @brief State for one evaluation of a compiled program
+ * @details The state owns a copy of the program's contexts, the scratch memory allocated through
+ * them and the intermediate results. Several states created from the same program can be
+ * evaluated concurrently, while the literals are shared with the program. The program must
+ * outlive the state and must not be modified while states are being evaluated.
+ */
+struct MIGRAPHX_EXPORT execution_state
+{
+    execution_state();
+
+    explicit execution_state(const program& p);
+
+    execution_state(const execution_state&);
+    execution_state(execution_state&&) noexcept;
+    execution_state& operator=(execution_state);
+
+    ~execution_state() noexcept;
+
+    std::vector<argument> eval(const std::unordered_map<std::string, argument>& params,
+                               execution_environment exec_env = execution_environment{});
+
+    /**
+     * @brief Write an output of the program to the buffer of the argument
+     * @details When the output is computed in an allocation of the program, the allocation is
+     * replaced by the buffer so the last instruction writes to it directly. Otherwise the result
+     * is copied to the buffer. The evaluation returns the bound argument for the output, which
+     * must stay alive while the state is evaluated.
+     */
+    void bind_output(std::size_t index, const argument& output);
+
+    /// Bind an output by its parameter name, such as `main:#output_0`
+    void bind_output(const std::string& name, const argument& output);
+
+    void finish() const;
+
+    context& get_context() const;
+
+    private:
+    std::unique_ptr<execution_state_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
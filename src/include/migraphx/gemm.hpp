@@ -25,38 +25,216 @@
 #define MIGRAPHX_GUARD_RTGLIB_GEMM_HPP
 
 #include <migraphx/config.hpp>
-#include <migraphx/dfor.hpp>
-#include <migraphx/par_for.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class T, class U, class F>
-void gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
+/// Returns true when MIGRAPHX_GEMM_DOUBLE_ACCUMULATION is set, to accumulate every gemm in double
+MIGRAPHX_EXPORT bool gemm_double_accumulation();
+
+// Integers accumulate in integers, so int8 gets the int32 accumulation of quant_dot, and the
+// other types accumulate in float unless they are double
+template <class T>
+using gemm_accumulator =
+    std::conditional_t<std::is_integral<T>{},
+                       std::conditional_t<(sizeof(T) <= 2), std::int32_t, std::int64_t>,
+                       std::conditional_t<std::is_same<T, double>{}, double, float>>;
+
+namespace detail {
+
+// The micro-kernel computes a gemm_mr x gemm_nr block of the output in registers. The panels of
+// a are gemm_mc x gemm_kc and the panels of b are gemm_kc x gemm_nc, so they stay in cache while
+// the micro-kernel sweeps over them.
+constexpr std::size_t gemm_mr = 6;
+constexpr std::size_t gemm_nr = 8;
+constexpr std::size_t gemm_mc = 96;
+constexpr std::size_t gemm_nc = 256;
+constexpr std::size_t gemm_kc = 256;
+
+// The offset of each matrix of s, for the batch indices of the output in order. Broadcasted
+// batch dimensions have a zero stride, so the same matrix is read again.
+inline std::vector<std::size_t> gemm_batch_offsets(const shape& output, const shape& s)
+{
+    std::vector<std::size_t> result = {0};
+    for(std::size_t d = 0; d + 2 < output.ndim(); d++)
+    {
+        std::vector<std::size_t> next;
+        next.reserve(result.size() * output.lens()[d]);
+        for(auto offset : result)
+        {
+            for(std::size_t i = 0; i < output.lens()[d]; i++)
+                next.push_back(offset + i * s.strides()[d]);
+        }
+        result = std::move(next);
+    }
+    return result;
+}
+
+// Pack mc x kc of a into panels of gemm_mr rows that are stored column by column. The last
+// panel is padded with zeros.
+template <class Acc, class U>
+void gemm_pack_a(
+    Acc* dst, const U* a, std::size_t rs, std::size_t cs, std::size_t mc, std::size_t kc)
+{
+    for(std::size_t i = 0; i < mc; i += gemm_mr)
+    {
+        auto rows = std::min(gemm_mr, mc - i);
+        for(std::size_t k = 0; k < kc; k++)
+        {
+            for(std::size_t r = 0; r < gemm_mr; r++)
+                *dst++ = r < rows ? static_cast<Acc>(a[(i + r) * rs + k * cs]) : Acc{0};
+        }
+    }
+}
+
+// Pack kc x nc of b into panels of gemm_nr columns that are stored row by row. The last panel is
+// padded with zeros.
+template <class Acc, class U>
+void gemm_pack_b(
+    Acc* dst, const U* b, std::size_t rs, std::size_t cs, std::size_t kc, std::size_t nc)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
-    std::size_t dim_0  = n_dims - 2;
-    std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
+    for(std::size_t j = 0; j < nc; j += gemm_nr)
+    {
+        auto cols = std::min(gemm_nr, nc - j);
+        for(std::size_t k = 0; k < kc; k++)
+        {
+            for(std::size_t c = 0; c < gemm_nr; c++)
+                *dst++ = c < cols ? static_cast<Acc>(b[k * rs + (j + c) * cs]) : Acc{0};
+        }
+    }
+}
+
+// Add the product of a packed panel of a and a packed panel of b to c. The inner loops have
+// fixed trip counts over contiguous data so the compiler keeps acc in vector registers.
+template <class Acc>
+void gemm_micro_kernel(std::size_t kc, const Acc* a, const Acc* b, Acc* c, std::size_t ldc)
+{
+    Acc acc[gemm_mr][gemm_nr] = {};
+    for(std::size_t k = 0; k < kc; k++)
+    {
+        for(std::size_t i = 0; i < gemm_mr; i++)
+        {
+            for(std::size_t j = 0; j < gemm_nr; j++)
+                acc[i][j] += a[i] * b[j];
+        }
+        a += gemm_mr;
+        b += gemm_nr;
+    }
+    for(std::size_t i = 0; i < gemm_mr; i++)
+    {
+        for(std::size_t j = 0; j < gemm_nr; j++)
+            c[i * ldc + j] += acc[i][j];
+    }
+}
+
+template <class Acc, class T, class U, class F>
+void gemm_impl(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
+{
+    const auto& cs = cmat.get_shape();
+    const auto& as = amat.get_shape();
+    const auto& bs = bmat.get_shape();
+    auto dim_0     = cs.ndim() - 2;
+    auto dim_1     = cs.ndim() - 1;
+    auto m         = cs.lens()[dim_0];
+    auto n         = cs.lens()[dim_1];
+    auto k         = as.lens()[dim_1];
+    assert(bs.lens()[dim_0] == k);
+    assert(as.lens()[dim_0] == m);
+    assert(bs.lens()[dim_1] == n);
+    auto c_offsets = gemm_batch_offsets(cs, cs);
+    auto a_offsets = gemm_batch_offsets(cs, as);
+    auto b_offsets = gemm_batch_offsets(cs, bs);
+    auto mblocks   = (m + gemm_mc - 1) / gemm_mc;
+    auto nblocks   = (n + gemm_nc - 1) / gemm_nc;
+    auto ntiles    = c_offsets.size() * mblocks * nblocks;
+    // The buffers are sized for the largest tile of this product, rounded up to whole panels
+    auto tile_m = (std::min(gemm_mc, m) + gemm_mr - 1) / gemm_mr * gemm_mr;
+    auto tile_n = (std::min(gemm_nc, n) + gemm_nr - 1) / gemm_nr * gemm_nr;
+    auto tile_k = std::min(gemm_kc, k);
+    // Each tile of the output is computed by one thread, so no accumulation is shared
+    auto run_tiles = [&](std::size_t start, std::size_t last, std::size_t) {
+        std::vector<Acc> apack(tile_m * tile_k);
+        std::vector<Acc> bpack(tile_k * tile_n);
+        std::vector<Acc> ctile(tile_m * tile_n);
+        for(auto tile = start; tile < last; tile++)
+        {
+            auto batch = tile / (mblocks * nblocks);
+            auto i0    = tile / nblocks % mblocks * gemm_mc;
+            auto j0    = tile % nblocks * gemm_nc;
+            auto mc    = std::min(gemm_mc, m - i0);
+            auto nc    = std::min(gemm_nc, n - j0);
+            // Only the mc x nc region is part of the output, the padding of the last panels is not
+            for(std::size_t i = 0; i < mc; i++)
+                std::fill_n(ctile.begin() + i * tile_n, nc, Acc{0});
+            for(std::size_t k0 = 0; k0 < k; k0 += gemm_kc)
+            {
+                auto kc = std::min(gemm_kc, k - k0);
+                gemm_pack_a(apack.data(),
+                            amat.data() + a_offsets[batch] + i0 * as.strides()[dim_0] +
+                                k0 * as.strides()[dim_1],
+                            as.strides()[dim_0],
+                            as.strides()[dim_1],
+                            mc,
+                            kc);
+                gemm_pack_b(bpack.data(),
+                            bmat.data() + b_offsets[batch] + k0 * bs.strides()[dim_0] +
+                                j0 * bs.strides()[dim_1],
+                            bs.strides()[dim_0],
+                            bs.strides()[dim_1],
+                            kc,
+                            nc);
+                for(std::size_t i = 0; i < mc; i += gemm_mr)
+                {
+                    for(std::size_t j = 0; j < nc; j += gemm_nr)
+                        gemm_micro_kernel(kc,
+                                          apack.data() + i * kc,
+                                          bpack.data() + j * kc,
+                                          ctile.data() + i * tile_n + j,
+                                          tile_n);
+                }
+            }
+            auto* c = cmat.data() + c_offsets[batch];
+            for(std::size_t i = 0; i < mc; i++)
+            {
+                for(std::size_t j = 0; j < nc; j++)
+                {
+                    auto& y  = c[(i0 + i) * cs.strides()[dim_0] + (j0 + j) * cs.strides()[dim_1]];
+                    double r = static_cast<double>(alpha) * ctile[i * tile_n + j];
+                    // The output is not read when beta is zero, since it may be uninitialized
+                    if(beta != 0)
+                        r += static_cast<double>(beta) * static_cast<double>(y);
+                    y = static_cast<T>(r);
+                }
+            }
+        }
+    };
+    get_thread_pool().parallel_for(ntiles, 1, run_tiles);
+}
 
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
+} // namespace detail
 
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
-                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
-    });
+/**
+ * Computes cmat = alpha * amat * bmat + beta * cmat over the last two dimensions, where the
+ * other dimensions are batches and can be broadcasted.
+ *
+ * The product is blocked: the panels of amat and bmat are packed into contiguous buffers in the
+ * accumulator type, and a register-blocked micro-kernel computes each block of the output. The
+ * tiles of the output are spread across the thread pool.
+ */
+template <class T, class U, class F>
+void gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
+{
+    if(gemm_double_accumulation())
+        detail::gemm_impl<double>(cmat, amat, bmat, alpha, beta);
+    else
+        detail::gemm_impl<gemm_accumulator<std::remove_cv_t<U>>>(cmat, amat, bmat, alpha, beta);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -172,6 +172,11 @@ struct MIGRAPHX_EXPORT instruction
 
     void replace(const shape& r);
 
+    // Increments the version of the module the instruction belongs to
+    void increment_version();
+
+    friend struct module_impl;
+
     operation op;
     shape result{};
     std::vector<instruction_ref> output;
@@ -180,6 +185,8 @@ struct MIGRAPHX_EXPORT instruction
     literal lit;
     bool normalized       = false;
     std::size_t target_id = 0;
+    // Set by the module when the instruction is inserted
+    std::size_t* module_version = nullptr;
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -70,6 +70,10 @@ struct MIGRAPHX_EXPORT module
 
     std::string name() const;
 
+    /// Returns a counter incremented whenever an instruction of the module is added, removed,
+    /// moved or modified, which is used to detect graphs changed after they were compiled
+    std::size_t get_version() const;
+
     bool bypass() const;
     void set_bypass(bool b = true);
 
@@ -26,6 +26,7 @@
 
 #include <migraphx/op/name.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/dyn_output.hpp>
@@ -60,6 +61,10 @@ struct binary : op_name<Derived>
         return {{"pointwise", true}, {"point_op", self.point_op()}};
     }
     value attributes() const { return base_attributes(); }
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return make_op_cost(output.elements(), output, inputs);
+    }
     shape compute_shape(std::vector<shape> inputs) const
     {
         check_shapes{inputs, static_cast<const Derived&>(*this), true}
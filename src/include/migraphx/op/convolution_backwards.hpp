@@ -29,10 +29,10 @@
 #include <migraphx/op/common.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/argument.hpp>
-#include <migraphx/par_dfor.hpp>
-#include <migraphx/shape_for_each.hpp>
+#include <migraphx/convolution.hpp>
 #include <migraphx/dyn_output.hpp>
 
 namespace migraphx {
@@ -142,71 +142,9 @@ struct convolution_backwards
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
-        auto num_spatial_dims = this->kdims();
         visit_all(result, args[0], args[1])([&](auto output, auto input, auto weights) {
-            using type = typename decltype(output)::value_type;
-
-            std::fill(output.begin(), output.end(), type{0});
-
-            auto in_lens = input.get_shape().lens();
-            auto in_n    = in_lens[0];
-            auto in_c    = in_lens[1];
-
-            auto wei   = weights.get_shape().lens();
-            auto wei_n = wei[0];
-            auto wei_c = wei[1];
-
-            auto out_lens = dyn_out.computed_shape.lens();
-
-            std::vector<std::size_t> win_size{in_c};
-            std::copy(in_lens.begin() + 2, in_lens.end(), std::back_inserter(win_size));
-            std::copy(wei.begin() + 2, wei.end(), std::back_inserter(win_size));
-            shape win_shape{dyn_out.computed_shape.type(), win_size};
-
-            par_dfor(in_n, wei_c)([&](int o, int k) {
-                shape_for_each(win_shape, [&](const auto& idx_win) {
-                    const int w = idx_win[0];
-
-                    auto input_dims_start = idx_win.begin() + 1;
-                    auto wei_dims_start   = idx_win.begin() + num_spatial_dims + 1;
-
-                    std::vector<std::ptrdiff_t> win_start;
-                    for(std::size_t n = 0; n < num_spatial_dims; ++n)
-                    {
-                        win_start.push_back(std::ptrdiff_t(*(input_dims_start + n) * stride[n]) -
-                                            std::ptrdiff_t(padding[n]));
-                    }
-
-                    const int group_id = w / (wei_n / group);
-                    const int in_ch    = group_id * wei_c + k;
-
-                    std::vector<std::ptrdiff_t> idx_out{o, in_ch};
-
-                    for(size_t n = 0; n < num_spatial_dims; n++)
-                    {
-                        idx_out.push_back(win_start[n] + *(wei_dims_start + n) * dilation[n]);
-                    }
-
-                    std::vector<std::ptrdiff_t> idx_wei{w, k};
-                    std::copy(wei_dims_start, idx_win.end(), std::back_inserter(idx_wei));
-
-                    std::vector<std::ptrdiff_t> idx_in{o, w};
-                    std::copy(input_dims_start, wei_dims_start, std::back_inserter(idx_in));
-
-                    if(std::all_of(
-                           idx_out.begin() + 2, idx_out.end(), [&](auto ii) { return ii >= 0; }) and
-                       std::equal(idx_out.begin() + 2,
-                                  idx_out.end(),
-                                  out_lens.begin() + 2,
-                                  out_lens.end(),
-                                  std::less<std::ptrdiff_t>{}))
-                    {
-                        output(idx_out.begin(), idx_out.end()) +=
-                            input(idx_in.begin(), idx_in.end()) *
-                            weights(idx_wei.begin(), idx_wei.end());
-                    }
-                });
-            });
+            migraphx::convolution_backwards(
+                output, input, weights, padding, stride, dilation, group);
         });
         return result;
     }
@@ -216,6 +154,15 @@ struct convolution_backwards
         check_attribute_size();
         return stride.size();
     }
+
+    // Each input element is scattered through one filter, which is (K / group) * kernel elements
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        const auto& x = inputs.at(0);
+        const auto& w = inputs.at(1);
+        auto filter   = w.elements() / w.lens().front();
+        return make_op_cost(2.0 * x.elements() * filter, output, {x, w});
+    }
 };
 
 } // namespace op
@@ -29,6 +29,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/gemm.hpp>
 #include <migraphx/dyn_output.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -127,6 +128,13 @@ struct dot
             [&](auto cmat, auto amat, auto bmat) { gemm(cmat, amat, bmat, 1.0f, 0.0f); });
         return result;
     }
+
+    // Each output element is a dot product over the inner dimension of A
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        auto k = inputs.at(0).lens().back();
+        return make_op_cost(2.0 * output.elements() * k, output, {inputs.at(0), inputs.at(1)});
+    }
 };
 
 } // namespace op
@@ -30,8 +30,10 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/literal.hpp>
+#include <migraphx/par.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
 #include <cmath>
@@ -124,22 +126,43 @@ struct gather
                 {
                     auto out_lens  = data.get_shape().lens();
                     out_lens[axis] = indices.get_shape().elements();
+                    // The output is standard, with the indices flattened into the axis. The
+                    // axis of the data is walked with a zero stride, and the offset of the
+                    // gathered row is added.
                     migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-                    shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                        auto data_idx   = out_idx_v;
-                        auto in_index   = indices[data_idx[axis]];
-                        in_index        = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                    auto data_strides = data.get_shape().strides();
+                    std::vector<std::size_t> rows(indices.get_shape().elements());
+                    auto row_offset = [&](auto in_index) {
+                        in_index = (in_index < 0) ? in_index + axis_dim_size : in_index;
                         // don't go out of bounds: https://github.com/ROCm/AMDMIGraphX/issues/2838
                         assert(in_index >= 0 and in_index < axis_dim_size);
-                        data_idx[axis]  = in_index;
-                        output[out_idx] = data(data_idx.begin(), data_idx.end());
-                    });
+                        return in_index * data_strides[axis];
+                    };
+                    std::transform(indices.begin(), indices.end(), rows.begin(), row_offset);
+                    data_strides[axis] = 0;
+                    const auto* in     = data.data();
+                    auto* out          = output.data();
+                    par_strided_for_each(out_lens,
+                                         std::array{data_strides, out_comp_shape.strides()},
+                                         par_transform_min_grain,
+                                         [&](const auto& out_idx, const auto& offsets) {
+                                             out[offsets[1]] = in[offsets[0] + rows[out_idx[axis]]];
+                                         });
                 }
             });
         });
 
         return result;
     }
+
+    // Only the gathered rows of the data are read, along with all of the indices
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        op_cost r;
+        r.bytes_read    = output.bytes() + inputs.at(1).bytes();
+        r.bytes_written = output.bytes();
+        return r;
+    }
 };
 
 } // namespace op
@@ -28,6 +28,7 @@
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -64,6 +65,12 @@ struct logsoftmax
         }
     }
 
+    // The max, subtract, exp, sum and final subtract are each one operation per element
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return make_op_cost(5.0 * output.elements(), output, inputs);
+    }
+
     auto output() const
     {
         return [=](auto x, auto y) { return std::log(x / y); };
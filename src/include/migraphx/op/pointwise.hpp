@@ -26,10 +26,14 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/eval_pointwise.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/permutation.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/op_cost.hpp>
+#include <migraphx/stringutils.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -64,18 +68,46 @@ struct pointwise
         return shape::from_permutation(type, inputs.front().lens(), find_permutation(inputs));
     }
 
+    using run_function = std::function<std::vector<argument>(
+        module_ref&, const std::unordered_map<std::string, argument>&)>;
+
     argument compute(const shape& output_shape,
                      const std::vector<argument>& args,
                      const std::vector<module_ref>& mods,
-                     const std::function<std::vector<argument>(
-                         module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+                     const run_function& run) const
+    {
+        return compute_pointwise(nullptr, output_shape, args, mods, run);
+    }
+
+    // The operators of a lowered submodule can need the context of the target
+    argument compute(context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const run_function& run) const
+    {
+        return compute_pointwise(&ctx, output_shape, args, mods, run);
+    }
+
+    argument compute_pointwise(context* ctx,
+                               const shape& output_shape,
+                               const std::vector<argument>& args,
+                               const std::vector<module_ref>& mods,
+                               const run_function& run) const
     {
-        argument output{output_shape};
         auto* pm    = mods.front();
         auto pnames = pm->get_parameter_names();
         std::sort(pnames.begin(), pnames.end());
 
-        par_for(output_shape.elements(), [&](auto i) {
+        auto result = eval_pointwise(ctx, output_shape, pm, pnames, args);
+        if(not result.empty())
+            return result;
+
+        // Otherwise evaluate the submodule for each element. Each evaluation has its own result
+        // slots, but the operators of a lowered submodule share the context, so those run one at
+        // a time.
+        argument output{output_shape};
+        auto eval_element = [&](std::size_t i) {
             std::unordered_map<std::string, argument> params;
 
             std::transform(
@@ -88,9 +120,31 @@ struct pointwise
             auto results = run(pm, params);
             assert(results.size() == 1);
             visit_all(output, results.front())([&](auto out, auto x) { out[i] = x.front(); });
-        });
+        };
+        if(ctx == nullptr)
+        {
+            par_for(output_shape.elements(), eval_element);
+        }
+        else
+        {
+            for(std::size_t i = 0; i < output_shape.elements(); i++)
+                eval_element(i);
+        }
         return output;
     }
+
+    // Every instruction in the submodule, other than parameters and literals, is one operation
+    // per output element
+    op_cost cost(const shape& output,
+                 const std::vector<shape>& inputs,
+                 const std::vector<module_ref>& mods) const
+    {
+        const auto* pm = mods.front();
+        auto n         = std::count_if(pm->begin(), pm->end(), [](const instruction& ins) {
+            return not starts_with(ins.name(), "@");
+        });
+        return make_op_cost(static_cast<double>(n) * output.elements(), output, inputs);
+    }
 };
 
 } // namespace op
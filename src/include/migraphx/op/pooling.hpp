@@ -27,13 +27,14 @@
 #include <migraphx/op/common.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/pad_calc.hpp>
-#include <migraphx/par_for.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <cmath>
+#include <numeric>
 #include <utility>
 
 namespace migraphx {
@@ -324,105 +325,114 @@ struct pooling
                       const std::vector<std::size_t>& padding_vals,
                       Op op) const
     {
-        auto in_s    = input.get_shape();
-        auto in_lens = in_s.lens();
-
-        // For each element of output; i.e., for each placement of pooling kernel...
-        par_for(output_shape.elements(), [&](auto i) {
-            auto idx_o = output_shape.multi(i);
-            auto n_dim = idx_o.size();
-            // starting offset of the pooling window
-            std::vector<int> win_start;
-            std::vector<std::size_t> win_size;
-
-            // For each spatial dimension, find starting and ending index of pooling kernel
-            for(std::size_t dim = 2; dim < n_dim; ++dim)
-            {
-                auto d_2  = dim - 2;
-                int start = static_cast<int>(idx_o[dim] * stride[d_2]) -
-                            static_cast<int>(padding_vals[d_2]);
-                int end;
-                std::size_t dilated_kernel_dim = dilate_dim(kernel_dims[d_2], dilations[d_2]);
-                // NOLINT
-                if(count_include_pad and ceil_mode and (mode != pooling_mode::max))
-                {
-                    // TODO: this block can't execute until we enable count_include_pad
-                    // Even when using padding, if in ceil_mode a window
-                    // could extend beyond the end of both input and
-                    // padding.  Clip out-of-bounds indexes but not padding.
-
-                    // Check if this kernel extends beyond the padding at end of dimension
-                    end = std::min(start + dilated_kernel_dim,
-                                   in_lens[dim] + static_cast<int>(padding_vals[d_2]));
-                }
-                else
-                {
-                    // In non-ceiling mode, when
-                    // count_include_pad is false, or for max pooling, clip off padding.
-                    end = std::min(start + dilated_kernel_dim, in_lens[dim]);
-                }
-                win_start.push_back(start);
-                if(end < start)
-                {
-                    // This error can be caused by misc. bad input combinations
-                    MIGRAPHX_THROW("POOLING:  invalid attributes");
-                }
-                win_size.push_back(end - start);
-            }
-
-            shape win_shape{output_shape.type(), win_size};
-
-            auto pool_size    = win_shape.elements();
-            double output_val = op.template init<Type>();
-
-            // for each element in the window...
-            shape_for_each(win_shape, [&](const auto& idx_w) {
-                // Skip elements that belong to the dilated area
-                for(size_t axis = 0; axis < idx_w.size(); ++axis)
-                {
-                    if(idx_w[axis] % dilations[axis])
-                    {
-                        pool_size -= 1;
-                        return;
-                    }
-                }
-
-                // the coordinates of this element
-                auto idx = idx_o;
-
-                // Add the kernel location idx_w and the offset win_start, for each dimension.
-                // Negative results are cast to very large unsigned integers.
-                std::transform(idx_w.begin(),
-                               idx_w.end(),
-                               win_start.begin(),
-                               idx.begin() + 2,
-                               [](auto ii, auto jj) { return ii + jj; });
-                // Check if any of coordinates are out of input tensor's range
-                if(std::mismatch(idx.begin() + 2,
-                                 idx.end(),
-                                 in_lens.begin() + 2,
-                                 in_lens.end(),
-                                 std::less<>{}) == std::make_pair(idx.end(), in_lens.end()))
-                {
-                    output_val = op(output_val, input[in_s.index(idx)]);
-                }
-                else
-                {
-                    // this is a padding element.  Padding locations
-                    // don't contribute to average or max pooling total but can play in
-                    // lpnorm pooling.
-                    if(mode == pooling_mode::lpnorm)
-                    {
-                        output_val = op(output_val, op.template init<Type>());
-                    }
-                    if(mode == pooling_mode::average)
-                    {
-                        // Ignore padding
-                        pool_size -= 1;
-                    }
-                }
-            });
-            output[i] = Type(op.final(output_val, pool_size));
+        auto in_s      = input.get_shape();
+        auto in_lens   = in_s.lens();
+        auto n_dim     = in_lens.size();
+        auto n_spatial = n_dim - 2;
+        // The batch and channel are walked with the output, the window adds the spatial offset
+        auto batch_strides = in_s.strides();
+        std::fill(batch_strides.begin() + 2, batch_strides.end(), 0);
+        std::vector<std::size_t> win_strides(in_s.strides().begin() + 2, in_s.strides().end());
+        const auto* in = input.data();
+        auto* out      = output.data();
+
+        visit_rank(n_dim, [&](auto rank) {
+            // For each element of output; i.e., for each placement of pooling kernel...
+            get_thread_pool().parallel_for(
+                output_shape.elements(), 1, [&](std::size_t first, std::size_t last, std::size_t) {
+                    stride_walker<rank, 2> w{output_shape.lens(),
+                                             std::array{batch_strides, output_shape.strides()},
+                                             first};
+                    w.for_each(last - first, [&](const auto& idx_o, const auto& offsets) {
+                        // starting offset of the pooling window. Negative starts wrap to very
+                        // large unsigned integers, which are then outside of the input.
+                        typename multi_index<rank>::array win_start(n_spatial);
+                        typename multi_index<rank>::array win_size(n_spatial);
+                        std::size_t base = offsets[0];
+
+                        // For each spatial dimension, find starting and ending index of pooling
+                        // kernel
+                        for(std::size_t d_2 = 0; d_2 < n_spatial; ++d_2)
+                        {
+                            auto dim  = d_2 + 2;
+                            int start = static_cast<int>(idx_o[dim] * stride[d_2]) -
+                                        static_cast<int>(padding_vals[d_2]);
+                            int end;
+                            std::size_t dilated_kernel_dim =
+                                dilate_dim(kernel_dims[d_2], dilations[d_2]);
+                            // NOLINT
+                            if(count_include_pad and ceil_mode and (mode != pooling_mode::max))
+                            {
+                                // TODO: this block can't execute until we enable count_include_pad
+                                // Even when using padding, if in ceil_mode a window
+                                // could extend beyond the end of both input and
+                                // padding.  Clip out-of-bounds indexes but not padding.
+
+                                // Check if this kernel extends beyond the padding at end of
+                                // dimension
+                                end = std::min(start + dilated_kernel_dim,
+                                               in_lens[dim] + static_cast<int>(padding_vals[d_2]));
+                            }
+                            else
+                            {
+                                // In non-ceiling mode, when
+                                // count_include_pad is false, or for max pooling, clip off
+                                // padding.
+                                end = std::min(start + dilated_kernel_dim, in_lens[dim]);
+                            }
+                            if(end < start)
+                            {
+                                // This error can be caused by misc. bad input combinations
+                                MIGRAPHX_THROW("POOLING:  invalid attributes");
+                            }
+                            win_start[d_2] = static_cast<std::size_t>(start);
+                            win_size[d_2]  = end - start;
+                            base += win_start[d_2] * win_strides[d_2];
+                        }
+
+                        stride_walker<rank, 1> win{win_size, std::array{win_strides}};
+                        auto win_elements = std::accumulate(
+                            win_size.begin(), win_size.end(), std::size_t{1}, std::multiplies<>{});
+                        auto pool_size    = win_elements;
+                        double output_val = op.template init<Type>();
+
+                        // for each element in the window...
+                        win.for_each(win_elements, [&](const auto& idx_w, const auto& w) {
+                            bool inside = true;
+                            for(std::size_t d_2 = 0; d_2 < n_spatial; ++d_2)
+                            {
+                                // Skip elements that belong to the dilated area
+                                if(idx_w[d_2] % dilations[d_2])
+                                {
+                                    pool_size -= 1;
+                                    return;
+                                }
+                                // Check if any of coordinates are out of input tensor's range
+                                inside = inside and win_start[d_2] + idx_w[d_2] < in_lens[d_2 + 2];
+                            }
+                            if(inside)
+                            {
+                                output_val = op(output_val, in[base + w[0]]);
+                            }
+                            else
+                            {
+                                // this is a padding element.  Padding locations
+                                // don't contribute to average or max pooling total but can play
+                                // in lpnorm pooling.
+                                if(mode == pooling_mode::lpnorm)
+                                {
+                                    output_val = op(output_val, op.template init<Type>());
+                                }
+                                if(mode == pooling_mode::average)
+                                {
+                                    // Ignore padding
+                                    pool_size -= 1;
+                                }
+                            }
+                        });
+                        out[offsets[1]] = Type(op.final(output_val, pool_size));
+                    });
+                });
         });
     }
 
@@ -493,6 +503,21 @@ struct pooling
 
         return result;
     }
+
+    // Each output element reduces one window, lpnorm also raises every element to a power
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        const auto& input = inputs.at(0);
+        std::size_t window =
+            dyn_global ? std::accumulate(input.lens().begin() + 2,
+                                         input.lens().end(),
+                                         std::size_t{1},
+                                         std::multiplies<>{})
+                       : std::accumulate(
+                             lengths.begin(), lengths.end(), std::size_t{1}, std::multiplies<>{});
+        double per_element = mode == pooling_mode::lpnorm ? 2.0 : 1.0;
+        return make_op_cost(per_element * output.elements() * window, output, inputs);
+    }
 };
 
 } // namespace op
@@ -29,6 +29,7 @@
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/convolution.hpp>
 #include <migraphx/value.hpp>
 #include <cmath>
@@ -133,6 +134,14 @@ struct quant_convolution
         });
         return result;
     }
+
+    // Each output element accumulates over one filter, which is (C / group) * kernel elements
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        const auto& w = inputs.at(1);
+        auto filter   = w.elements() / w.lens().front();
+        return make_op_cost(2.0 * output.elements() * filter, output, {inputs.at(0), w});
+    }
 };
 
 } // namespace op
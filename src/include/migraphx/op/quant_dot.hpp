@@ -27,6 +27,7 @@
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/gemm.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/value.hpp>
 
 namespace migraphx {
@@ -82,6 +83,13 @@ struct quant_dot
         } // else int8 gemm
         return {shape::int32_type, out_lens};
     }
+
+    // Each output element is a dot product over the inner dimension of A
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        auto k = inputs.at(0).lens().back();
+        return make_op_cost(2.0 * output.elements() * k, output, {inputs.at(0), inputs.at(1)});
+    }
 };
 
 } // namespace op
@@ -29,9 +29,9 @@
 #include <migraphx/dyn_output.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/tensor_view.hpp>
-#include <migraphx/shape_for_each.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/reduce.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
 #include <vector>
@@ -192,27 +192,6 @@ struct reduce_op : op_name<Derived>
         }
     }
 
-    template <class T>
-    void reduce(const tensor_view<T>& input,
-                const shape& batch_shape,
-                const std::vector<int64_t>& tuned_axes,
-                const std::vector<std::size_t>& out_idx,
-                tensor_view<T>& output) const
-    {
-        using accumulator = accumulator_type<T>;
-        auto& self        = static_cast<const Derived&>(*this);
-        auto data_idx     = out_idx;
-        accumulator val   = self.init();
-        shape_for_each(batch_shape, [&](const auto& b_idx) {
-            this->tune_dims(tuned_axes, b_idx, data_idx);
-            accumulator x = input(data_idx.begin(), data_idx.end());
-            val           = self.op()(accumulator{self.input()(x)}, val);
-        });
-
-        output(out_idx.begin(), out_idx.end()) =
-            static_cast<const Derived&>(*this).output(batch_shape)(val);
-    }
-
     argument reduce(const shape& computed_shape,
                     const std::vector<int64_t>& reduce_axes,
                     argument& data_arg) const
@@ -222,12 +201,21 @@ struct reduce_op : op_name<Derived>
         tune_dims(reduce_axes, arg_lens, batch_lens);
         shape batch_shape{computed_shape.type(), batch_lens};
         argument result{computed_shape};
+        auto& self = static_cast<const Derived&>(*this);
 
         visit_all(result, data_arg)([&](auto output, auto input) {
-            par_for(computed_shape.elements(), [&](auto i) {
-                auto out_idx = computed_shape.multi(i);
-                this->reduce(input, batch_shape, reduce_axes, out_idx, output);
-            });
+            using accumulator = accumulator_type<typename decltype(input)::value_type>;
+            accumulator init  = self.init();
+            migraphx::reduce(
+                output,
+                input,
+                self.op(),
+                init,
+                [&](auto x) {
+                    accumulator a = x;
+                    return accumulator{self.input()(a)};
+                },
+                self.output(batch_shape));
         });
 
         return result;
@@ -262,6 +250,13 @@ struct reduce_op : op_name<Derived>
         return [](auto val) { return val; };
     }
 
+    // One operation for every element that is reduced
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        const auto& data = inputs.at(0);
+        return make_op_cost(data.elements(), output, {data});
+    }
+
     reduce_op() {}
     reduce_op(std::vector<int64_t> ax) : axes(std::move(ax)) {}
 };
@@ -30,6 +30,7 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/literal.hpp>
+#include <migraphx/par.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/config.hpp>
 #include <cmath>
@@ -289,16 +290,31 @@ struct resize
 
         // Populate each element in output by selecting "nearest" item in input.
         visit_all(result, args[0])([&](auto output, auto data) {
-            migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-            shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                std::vector<size_t> in_idx(out_idx_v.size());
-                for(auto ii = 0; ii < out_idx_v.size(); ++ii)
+            // The nearest input of each output coordinate only depends on its own dimension, so
+            // the offsets along each dimension are computed once
+            const auto& in_strides = data.get_shape().strides();
+            std::vector<std::vector<std::size_t>> dim_offsets(out_lens.size());
+            for(std::size_t ii = 0; ii < out_lens.size(); ++ii)
+            {
+                dim_offsets[ii].resize(out_lens[ii]);
+                for(std::size_t j = 0; j < out_lens[ii]; ++j)
                 {
-                    auto idx_val = idx_op(in_lens[ii], out_lens[ii], out_idx_v[ii], vec_scale[ii]);
-                    in_idx[ii]   = nearest_op(in_lens[ii], idx_val);
+                    auto idx_val       = idx_op(in_lens[ii], out_lens[ii], j, vec_scale[ii]);
+                    dim_offsets[ii][j] = nearest_op(in_lens[ii], idx_val) * in_strides[ii];
                 }
-                output[out_idx] = data(in_idx.begin(), in_idx.end());
-            });
+            }
+            const auto* in = data.data();
+            auto* out      = output.data();
+            par_strided_for_each(
+                out_lens,
+                std::array{output_shape.strides()},
+                par_transform_min_grain,
+                [&](const auto& out_idx_v, const auto& offsets) {
+                    std::size_t in_offset = 0;
+                    for(std::size_t ii = 0; ii < out_idx_v.size(); ++ii)
+                        in_offset += dim_offsets[ii][out_idx_v[ii]];
+                    out[offsets[0]] = in[in_offset];
+                });
         });
         return result;
     }
@@ -29,7 +29,7 @@
 #include <migraphx/argument.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/value.hpp>
 
@@ -119,40 +119,42 @@ struct topk
 
         // compute shape
         comp_lens[axis] = 1;
-        shape comp_s{in_s.type(), comp_lens};
+        auto in_axis    = in_s.strides()[axis];
+        auto out_axis   = out_s.strides()[axis];
+        auto ind_s      = vec_ss.back();
+        auto ind_axis   = ind_s.strides()[axis];
         visit_all(res_val, args.front())([&](auto out_val, auto input) {
-            auto* out_ind = res_ind.cast<int64_t>();
-            par_for(comp_s.elements(), [&](auto i) {
-                auto idx = comp_s.multi(i);
-                std::vector<std::size_t> indices(k);
-                std::iota(indices.begin(), indices.end(), 0);
-
-                auto comp = [&](auto i1, auto i2) {
-                    auto idx1  = idx;
-                    auto idx2  = idx;
-                    idx1[axis] = i1;
-                    idx2[axis] = i2;
-                    return this->largest
-                               ? std::greater<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)])
-                               : std::less<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)]);
-                };
-
-                auto hp = this->make_heap(indices, comp);
-                for(std::size_t ii = indices.size(); ii < axis_dim; ++ii)
-                {
-                    hp.try_push(ii);
-                }
-                auto sorted_indices = hp.sort();
-                auto out_idx        = idx;
-                auto in_idx         = idx;
-                for(auto j : range(sorted_indices.size()))
-                {
-                    out_idx[axis]                 = j;
-                    in_idx[axis]                  = sorted_indices[j];
-                    out_val[out_s.index(out_idx)] = input[in_s.index(in_idx)];
-                    out_ind[out_s.index(out_idx)] = sorted_indices[j];
-                }
-            });
+            auto* out_ind  = res_ind.cast<int64_t>();
+            const auto* in = input.data();
+            auto* out      = out_val.data();
+            // Each element of the compute shape is the start of a row along the axis
+            par_strided_for_each(
+                comp_lens,
+                std::array{in_s.strides(), out_s.strides(), ind_s.strides()},
+                1,
+                [&](const auto& offsets) {
+                    std::vector<std::size_t> indices(k);
+                    std::iota(indices.begin(), indices.end(), 0);
+
+                    const auto* row = in + offsets[0];
+                    auto comp       = [&](auto i1, auto i2) {
+                        return this->largest
+                                   ? std::greater<>{}(row[i1 * in_axis], row[i2 * in_axis])
+                                   : std::less<>{}(row[i1 * in_axis], row[i2 * in_axis]);
+                    };
+
+                    auto hp = this->make_heap(indices, comp);
+                    for(std::size_t ii = indices.size(); ii < axis_dim; ++ii)
+                    {
+                        hp.try_push(ii);
+                    }
+                    auto sorted_indices = hp.sort();
+                    for(auto j : range(sorted_indices.size()))
+                    {
+                        out[offsets[1] + j * out_axis]     = row[sorted_indices[j] * in_axis];
+                        out_ind[offsets[2] + j * ind_axis] = sorted_indices[j];
+                    }
+                });
         });
 
         return {{res_val, res_ind}};
@@ -26,6 +26,7 @@
 
 #include <migraphx/op/name.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/stringutils.hpp>
@@ -62,6 +63,10 @@ struct unary : op_name<Derived>
         return {{"pointwise", true}, {"point_op", self.point_op()}};
     }
     value attributes() const { return base_attributes(); }
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return make_op_cost(output.elements(), output, inputs);
+    }
     shape compute_shape(std::vector<shape> inputs) const
     {
         check_shapes{inputs, static_cast<const Derived&>(*this), true}.has(1);
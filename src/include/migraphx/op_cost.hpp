@@ -0,0 +1,103 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_OP_COST_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_OP_COST_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/shape.hpp>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief An estimate of the work an operator does for one evaluation
+ *
+ * Flops count every arithmetic operation (multiply and add are two), including integer
+ * operations for the quantized operators. Bytes count the memory each input and the output
+ * occupies, so a broadcasted input is only counted once.
+ */
+struct op_cost
+{
+    double flops              = 0;
+    std::size_t bytes_read    = 0;
+    std::size_t bytes_written = 0;
+
+    std::size_t bytes() const { return bytes_read + bytes_written; }
+
+    /// Flops per byte moved, or zero when no memory is accessed
+    double intensity() const
+    {
+        if(bytes() == 0)
+            return 0;
+        return flops / bytes();
+    }
+
+    /// True when the operator did not report a cost
+    bool empty() const { return flops == 0 and bytes() == 0; }
+
+    op_cost& operator+=(const op_cost& x)
+    {
+        flops += x.flops;
+        bytes_read += x.bytes_read;
+        bytes_written += x.bytes_written;
+        return *this;
+    }
+
+    friend op_cost operator+(op_cost x, const op_cost& y) { return x += y; }
+
+    friend bool operator==(const op_cost& x, const op_cost& y)
+    {
+        return x.flops == y.flops and x.bytes_read == y.bytes_read and
+               x.bytes_written == y.bytes_written;
+    }
+    friend bool operator!=(const op_cost& x, const op_cost& y) { return not(x == y); }
+
+    friend std::ostream& operator<<(std::ostream& os, const op_cost& x)
+    {
+        os << "flops=" << x.flops << ", bytes_read=" << x.bytes_read
+           << ", bytes_written=" << x.bytes_written;
+        return os;
+    }
+};
+
+/// Cost of an operator that reads all of its inputs and writes its output once
+inline op_cost make_op_cost(double flops, const shape& output, const std::vector<shape>& inputs)
+{
+    op_cost r;
+    r.flops      = flops;
+    r.bytes_read = std::accumulate(
+        inputs.begin(), inputs.end(), std::size_t{0}, [](std::size_t n, const shape& s) {
+            return n + s.bytes();
+        });
+    r.bytes_written = output.bytes();
+    return r;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -41,6 +41,7 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/auto_any_cast.hpp>
 #include <migraphx/lifetime.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/config.hpp>
 
 namespace migraphx {
@@ -82,6 +83,9 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method that estimates the flops and the bytes read and written for one
+    /// evaluation with the given shapes. Operators that don't implement it report an empty cost.
+    op_cost cost(const shape& output, const std::vector<shape>& input) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -93,6 +97,8 @@ bool is_context_free(const operation& x);
 bool need_normalization(const operation& x);
 /// Returns true if the operation has a finalize method
 bool has_finalize(const operation& x);
+/// Returns the estimated cost of the operation, which is empty when it isn't implemented
+op_cost cost(const operation& x, const shape& output, const std::vector<shape>& inputs);
 
 #else
 
@@ -496,6 +502,55 @@ lifetime get_lifetime_op(const T&)
     return lifetime::local;
 }
 
+template <class T>
+auto cost_op(rank<1>, const T& x, const shape& output, const std::vector<shape>& inputs)
+    -> decltype(x.cost(output, inputs))
+{
+    return x.cost(output, inputs);
+}
+
+template <class T>
+op_cost cost_op(rank<0>, const T&, const shape&, const std::vector<shape>&)
+{
+    return {};
+}
+
+template <class T>
+op_cost cost_op(const T& x, const shape& output, const std::vector<shape>& inputs)
+{
+    return cost_op(rank<1>{}, x, output, inputs);
+}
+
+template <class T>
+auto mod_cost_op(rank<1>,
+                 const T& x,
+                 const shape& output,
+                 const std::vector<shape>& inputs,
+                 const std::vector<module_ref>& mod_args)
+    -> decltype(x.cost(output, inputs, mod_args))
+{
+    return x.cost(output, inputs, mod_args);
+}
+
+template <class T>
+op_cost mod_cost_op(rank<0>,
+                    const T& x,
+                    const shape& output,
+                    const std::vector<shape>& inputs,
+                    const std::vector<module_ref>&)
+{
+    return cost_op(x, output, inputs);
+}
+
+template <class T>
+op_cost mod_cost_op(const T& x,
+                    const shape& output,
+                    const std::vector<shape>& inputs,
+                    const std::vector<module_ref>& mod_args)
+{
+    return mod_cost_op(rank<1>{}, x, output, inputs, mod_args);
+}
+
 } // namespace detail
 
 #ifdef TYPE_ERASED_DECLARATION
@@ -547,6 +602,12 @@ struct MIGRAPHX_EXPORT operation
     void from_value(const value& v);
     // (optional)
     value attributes() const;
+    // (optional)
+    op_cost cost(const shape& output, const std::vector<shape>& input) const;
+    // (optional)
+    op_cost cost(const shape& output,
+                 const std::vector<shape>& inputs,
+                 const std::vector<module_ref>& mod_args) const;
     //
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
     //
@@ -732,6 +793,20 @@ struct operation
         return (*this).private_detail_te_get_handle().attributes();
     }
 
+    op_cost cost(const shape& output, const std::vector<shape>& input) const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().cost(output, input);
+    }
+
+    op_cost cost(const shape& output,
+                 const std::vector<shape>& inputs,
+                 const std::vector<module_ref>& mod_args) const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().cost(output, inputs, mod_args);
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const operation& op)
     {
         assert(op.private_detail_te_handle_mem_var);
@@ -789,6 +864,10 @@ struct operation
         virtual value to_value() const                                                         = 0;
         virtual void from_value(const value& v)                                                = 0;
         virtual value attributes() const                                                       = 0;
+        virtual op_cost cost(const shape& output, const std::vector<shape>& input) const       = 0;
+        virtual op_cost cost(const shape& output,
+                             const std::vector<shape>& inputs,
+                             const std::vector<module_ref>& mod_args) const                   = 0;
         virtual std::ostream& operator_shift_left(std::ostream& os) const                      = 0;
         virtual bool operator==(const operation& y) const                                      = 0;
     };
@@ -1079,6 +1158,46 @@ struct operation
         return detail::attributes_op(private_detail_te_self);
     }
 
+    template <class T>
+    static auto private_detail_te_default_cost(char,
+                                               T&& private_detail_te_self,
+                                               const shape& output,
+                                               const std::vector<shape>& input)
+        -> decltype(private_detail_te_self.cost(output, input))
+    {
+        return private_detail_te_self.cost(output, input);
+    }
+
+    template <class T>
+    static op_cost private_detail_te_default_cost(float,
+                                                  T&& private_detail_te_self,
+                                                  const shape& output,
+                                                  const std::vector<shape>& input)
+    {
+        return detail::cost_op(private_detail_te_self, output, input);
+    }
+
+    template <class T>
+    static auto private_detail_te_default_cost(char,
+                                               T&& private_detail_te_self,
+                                               const shape& output,
+                                               const std::vector<shape>& inputs,
+                                               const std::vector<module_ref>& mod_args)
+        -> decltype(private_detail_te_self.cost(output, inputs, mod_args))
+    {
+        return private_detail_te_self.cost(output, inputs, mod_args);
+    }
+
+    template <class T>
+    static op_cost private_detail_te_default_cost(float,
+                                                  T&& private_detail_te_self,
+                                                  const shape& output,
+                                                  const std::vector<shape>& inputs,
+                                                  const std::vector<module_ref>& mod_args)
+    {
+        return detail::mod_cost_op(private_detail_te_self, output, inputs, mod_args);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -1226,6 +1345,21 @@ struct operation
             return private_detail_te_default_attributes(char(0), private_detail_te_value);
         }
 
+        op_cost cost(const shape& output, const std::vector<shape>& input) const override
+        {
+
+            return private_detail_te_default_cost(char(0), private_detail_te_value, output, input);
+        }
+
+        op_cost cost(const shape& output,
+                     const std::vector<shape>& inputs,
+                     const std::vector<module_ref>& mod_args) const override
+        {
+
+            return private_detail_te_default_cost(
+                char(0), private_detail_te_value, output, inputs, mod_args);
+        }
+
         std::ostream& operator_shift_left(std::ostream& os) const override
         {
             using migraphx::detail::operation_operators::operator<<;
@@ -1392,6 +1526,17 @@ bool has_finalize(const T& x)
     return detail::has_finalize_op(x);
 }
 
+inline op_cost cost(const operation& op, const shape& output, const std::vector<shape>& inputs)
+{
+    return op.cost(output, inputs);
+}
+
+template <class T>
+op_cost cost(const T& op, const shape& output, const std::vector<shape>& inputs)
+{
+    return detail::cost_op(op, output, inputs);
+}
+
 MIGRAPHX_EXPORT void migraphx_to_value(value& v, const operation& op);
 MIGRAPHX_EXPORT void migraphx_from_value(const value& v, operation& op);
 
@@ -25,85 +25,47 @@
 #define MIGRAPHX_GUARD_MIGRAPHX_PAR_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/simple_par_for.hpp>
 #if MIGRAPHX_HAS_EXECUTORS
 #include <execution>
-#else
-#include <migraphx/simple_par_for.hpp>
 #endif
 #include <algorithm>
-#include <mutex>
-#include <vector>
+#include <iterator>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-namespace detail {
-
-struct exception_list
-{
-    std::vector<std::exception_ptr> exceptions;
-    std::mutex m;
-    void add_exception()
-    {
-        std::lock_guard<std::mutex> guard(m);
-        exceptions.push_back(std::current_exception());
-    }
-    template <class F>
-    auto collect(F f)
-    {
-        return [f, this](auto&&... xs) {
-            try
-            {
-                f(std::forward<decltype(xs)>(xs)...);
-            }
-            catch(...)
-            {
-                this->add_exception();
-            }
-        };
-    }
-    void throw_if_exception() const
-    {
-        if(not exceptions.empty())
-            std::rethrow_exception(exceptions.front());
-    }
-};
-
-} // namespace detail
+// Elementwise transforms are cheap, so only split them when there is enough work for each thread
+constexpr std::size_t par_transform_min_grain = 1024;
 
 template <class InputIt, class OutputIt, class UnaryOperation>
 OutputIt par_transform(InputIt first1, InputIt last1, OutputIt d_first, UnaryOperation unary_op)
 {
-#if MIGRAPHX_HAS_EXECUTORS
-    return std::transform(std::execution::par, first1, last1, d_first, std::move(unary_op));
-#else
-    return std::transform(first1, last1, d_first, std::move(unary_op));
-#endif
+    auto n = std::distance(first1, last1);
+    get_thread_pool().parallel_for(
+        n, par_transform_min_grain, [&](std::size_t start, std::size_t last, std::size_t) {
+            std::transform(first1 + start, first1 + last, d_first + start, unary_op);
+        });
+    return d_first + n;
 }
 
 template <class InputIt1, class InputIt2, class OutputIt, class BinaryOperation>
 OutputIt par_transform(
     InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first, BinaryOperation binary_op)
 {
-#if MIGRAPHX_HAS_EXECUTORS
-    return std::transform(
-        std::execution::par, first1, last1, first2, d_first, std::move(binary_op));
-#else
-    return std::transform(first1, last1, first2, d_first, std::move(binary_op));
-#endif
+    auto n = std::distance(first1, last1);
+    get_thread_pool().parallel_for(
+        n, par_transform_min_grain, [&](std::size_t start, std::size_t last, std::size_t) {
+            std::transform(
+                first1 + start, first1 + last, first2 + start, d_first + start, binary_op);
+        });
+    return d_first + n;
 }
 
 template <class InputIt, class UnaryFunction>
 void par_for_each(InputIt first, InputIt last, UnaryFunction f)
 {
-#if MIGRAPHX_HAS_EXECUTORS
-    // Propagate the exception
-    detail::exception_list ex;
-    std::for_each(std::execution::par, first, last, ex.collect(std::move(f)));
-    ex.throw_if_exception();
-#else
     simple_par_for(last - first, [&](auto i) { f(first[i]); });
-#endif
 }
 
 template <class... Ts>
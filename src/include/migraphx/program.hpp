@@ -151,6 +151,8 @@ struct MIGRAPHX_EXPORT program
     void remove_module(const std::string& name);
     void remove_unused_modules();
 
+    friend struct execution_state;
+
     private:
     void assign(const program& p);
     std::unique_ptr<program_impl> impl;
@@ -0,0 +1,197 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_REDUCE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_REDUCE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+namespace detail {
+
+// Each thread gets at least this many elements to reduce
+constexpr std::size_t reduce_min_work = 16 * 1024;
+// Outputs accumulated together when reducing over the outer dimensions
+constexpr std::size_t reduce_columns = 256;
+// Independent accumulators for the innermost dimension, so the loop can be vectorized
+constexpr std::size_t reduce_lanes = 8;
+
+// Reduce n contiguous elements into val, with independent accumulators that are combined at the
+// end. This also keeps the partial sums smaller than one running sum.
+template <class T, class Acc, class Op, class Read>
+Acc reduce_contiguous(const T* x, std::size_t n, Acc init, Acc val, Op op, Read read)
+{
+    std::array<Acc, reduce_lanes> partial;
+    partial.fill(init);
+    std::size_t i = 0;
+    for(; i + reduce_lanes <= n; i += reduce_lanes)
+    {
+        for(std::size_t l = 0; l < reduce_lanes; l++)
+            partial[l] = op(read(x[i + l]), partial[l]);
+    }
+    for(; i < n; i++)
+        partial[0] = op(read(x[i]), partial[0]);
+    for(const auto& p : partial)
+        val = op(p, val);
+    return val;
+}
+
+} // namespace detail
+
+/**
+ * Reduces input into output over the dimensions where output has a length of one. Each output
+ * is write(r), where r is init combined with op(read(x), r) for every element x that is reduced.
+ * The op must be associative, since the elements are not combined in order.
+ *
+ * The dimensions are first collapsed with reduce_dims, which leaves one kept and one reduced
+ * dimension for the common layouts. When the innermost reduced dimension is contiguous each
+ * output is reduced with several accumulators. When the innermost kept dimension is contiguous
+ * instead, a block of outputs is accumulated together, one reduced row at a time. The outputs
+ * are spread across the thread pool.
+ */
+template <class T, class U, class Op, class Acc, class Read, class Write>
+void reduce(tensor_view<T> output, tensor_view<U> input, Op op, Acc init, Read read, Write write)
+{
+    auto nout = output.get_shape().elements();
+    if(nout == 0)
+        return;
+    auto shapes = reduce_dims({input.get_shape(), output.get_shape()});
+    const auto& in_s  = shapes[0];
+    const auto& out_s = shapes[1];
+    std::vector<std::size_t> klens;
+    std::vector<std::size_t> kin;
+    std::vector<std::size_t> kout;
+    std::vector<std::size_t> rlens;
+    std::vector<std::size_t> rin;
+    for(std::size_t d = 0; d < in_s.ndim(); d++)
+    {
+        if(out_s.lens()[d] == 1 and in_s.lens()[d] != 1)
+        {
+            rlens.push_back(in_s.lens()[d]);
+            rin.push_back(in_s.strides()[d]);
+        }
+        else
+        {
+            klens.push_back(in_s.lens()[d]);
+            kin.push_back(in_s.strides()[d]);
+            kout.push_back(out_s.strides()[d]);
+        }
+    }
+    const auto* x = input.data();
+    auto* y       = output.data();
+    auto rsize    = std::max<std::size_t>(1, input.get_shape().elements() / nout);
+    auto grain    = std::max<std::size_t>(1, detail::reduce_min_work / rsize);
+    auto& pool    = get_thread_pool();
+
+    // The dimensions after reduce_dims are at most the rank of the input
+    visit_rank(in_s.ndim(), [&](auto rank) {
+        if(not rlens.empty() and rin.back() == 1)
+        {
+            // Reduce the contiguous rows of the innermost dimension, the other reduced dimensions
+            // are the rows
+            auto row_len = rlens.back();
+            rlens.pop_back();
+            rin.pop_back();
+            pool.parallel_for(nout, grain, [&](std::size_t start, std::size_t last, std::size_t) {
+                stride_walker<rank, 2> kept{klens, std::array{kin, kout}, start};
+                stride_walker<rank, 1> rows{rlens, std::array{rin}};
+                auto nrows = std::accumulate(
+                    rlens.begin(), rlens.end(), std::size_t{1}, std::multiplies<>{});
+                kept.for_each(last - start, [&](const auto& k) {
+                    Acc val = init;
+                    rows.seek(0);
+                    rows.for_each(nrows, [&](const auto& r) {
+                        val = detail::reduce_contiguous(
+                            x + k[0] + r[0], row_len, init, val, op, read);
+                    });
+                    y[k[1]] = write(val);
+                });
+            });
+        }
+        else if(not rlens.empty() and not klens.empty() and kin.back() == 1)
+        {
+            // Accumulate blocks of contiguous outputs together over every reduced element
+            auto col_len = klens.back();
+            auto out_col = kout.back();
+            klens.pop_back();
+            kin.pop_back();
+            kout.pop_back();
+            auto nblocks = (col_len + detail::reduce_columns - 1) / detail::reduce_columns;
+            auto ntasks  = (nout / col_len) * nblocks;
+            auto tgrain  = std::max<std::size_t>(1, grain / detail::reduce_columns);
+            pool.parallel_for(
+                ntasks, tgrain, [&](std::size_t start, std::size_t last, std::size_t) {
+                    stride_walker<rank, 2> kept{klens, std::array{kin, kout}};
+                    stride_walker<rank, 1> reduced{rlens, std::array{rin}};
+                    std::array<Acc, detail::reduce_columns> acc;
+                    for(auto task = start; task < last; task++)
+                    {
+                        auto j0 = task % nblocks * detail::reduce_columns;
+                        auto n  = std::min(detail::reduce_columns, col_len - j0);
+                        kept.seek(task / nblocks);
+                        kept.for_each(1, [&](const auto& k) {
+                            std::fill(acc.begin(), acc.begin() + n, init);
+                            reduced.seek(0);
+                            reduced.for_each(rsize, [&](const auto& r) {
+                                const auto* p = x + k[0] + r[0] + j0;
+                                for(std::size_t j = 0; j < n; j++)
+                                    acc[j] = op(read(p[j]), acc[j]);
+                            });
+                            for(std::size_t j = 0; j < n; j++)
+                                y[k[1] + (j0 + j) * out_col] = write(acc[j]);
+                        });
+                    }
+                });
+        }
+        else
+        {
+            pool.parallel_for(nout, grain, [&](std::size_t start, std::size_t last, std::size_t) {
+                stride_walker<rank, 2> kept{klens, std::array{kin, kout}, start};
+                stride_walker<rank, 1> reduced{rlens, std::array{rin}};
+                kept.for_each(last - start, [&](const auto& k) {
+                    Acc val = init;
+                    reduced.seek(0);
+                    reduced.for_each(rsize,
+                                     [&](const auto& r) { val = op(read(x[k[0] + r[0]]), val); });
+                    y[k[1]] = write(val);
+                });
+            });
+        }
+    });
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
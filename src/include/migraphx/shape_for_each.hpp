@@ -26,35 +26,328 @@
 
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/thread_pool.hpp>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+/// Largest rank stored inline by the iterators below. Larger ranks use a vector, which is
+/// allocated once when the iterator is created.
+constexpr std::size_t max_inline_rank = 6;
+
+namespace detail {
+
+template <std::size_t N>
+struct fixed_index_array
+{
+    explicit fixed_index_array(std::size_t n = 0) : m_size(n) { assert(n <= N); }
+
+    std::size_t size() const { return m_size; }
+
+    std::size_t* data() { return m_data.data(); }
+    const std::size_t* data() const { return m_data.data(); }
+
+    std::size_t* begin() { return data(); }
+    const std::size_t* begin() const { return data(); }
+
+    std::size_t* end() { return data() + size(); }
+    const std::size_t* end() const { return data() + size(); }
+
+    std::size_t& operator[](std::size_t i) { return m_data[i]; }
+    std::size_t operator[](std::size_t i) const { return m_data[i]; }
+
+    private:
+    std::array<std::size_t, N> m_data = {};
+    std::size_t m_size                = 0;
+};
+
+// Up to N indices stored inline, or a vector when N is zero
+template <std::size_t N>
+using index_array = std::conditional_t<N == 0, std::vector<std::size_t>, fixed_index_array<N>>;
+
+} // namespace detail
+
+/**
+ * Calls f with std::integral_constant<std::size_t, N>, where N is the capacity to use for
+ * the iterators of a tensor of rank n: max_inline_rank when it fits, otherwise zero.
+ */
+template <class F>
+void visit_rank(std::size_t n, F f)
+{
+    if(n <= max_inline_rank)
+        f(std::integral_constant<std::size_t, max_inline_rank>{});
+    else
+        f(std::integral_constant<std::size_t, 0>{});
+}
+
+/**
+ * A multi-dimensional index into lens with a capacity of N dimensions, or any rank when N is
+ * zero. Advancing it carries into the outer dimensions, instead of decomposing the element
+ * index on every step as shape::multi does.
+ */
+template <std::size_t N = 0>
+struct multi_index
+{
+    using array = detail::index_array<N>;
+
+    multi_index() = default;
+
+    template <class Lens>
+    explicit multi_index(const Lens& lens, std::size_t i = 0)
+        : m_lens(lens.size()), m_index(lens.size())
+    {
+        std::copy(lens.begin(), lens.end(), m_lens.begin());
+        seek(i);
+    }
+
+    std::size_t size() const { return m_index.size(); }
+
+    const array& lens() const { return m_lens; }
+
+    std::size_t* begin() { return m_index.data(); }
+    const std::size_t* begin() const { return m_index.data(); }
+
+    std::size_t* end() { return m_index.data() + size(); }
+    const std::size_t* end() const { return m_index.data() + size(); }
+
+    std::size_t& operator[](std::size_t i) { return m_index[i]; }
+    std::size_t operator[](std::size_t i) const { return m_index[i]; }
+
+    /// Moves to the i-th element in order
+    void seek(std::size_t i)
+    {
+        for(auto d = size(); d > 0; d--)
+        {
+            auto len       = m_lens[d - 1];
+            m_index[d - 1] = len == 0 ? 0 : i % len;
+            i              = len == 0 ? 0 : i / len;
+        }
+    }
+
+    /// Moves to the next element, and returns the outermost dimension that was incremented
+    std::size_t next()
+    {
+        if(size() == 0)
+            return 0;
+        auto d = size() - 1;
+        m_index[d]++;
+        while(d > 0 and m_index[d] == m_lens[d])
+        {
+            m_index[d] = 0;
+            d--;
+            m_index[d]++;
+        }
+        return d;
+    }
+
+    /// Moves forward by n elements
+    void increment(std::size_t n)
+    {
+        for(auto d = size(); d > 1 and n > 0; d--)
+        {
+            auto z         = m_index[d - 1] + n;
+            m_index[d - 1] = z % m_lens[d - 1];
+            n              = z / m_lens[d - 1];
+        }
+        if(size() > 0)
+            m_index[0] += n;
+    }
+
+    multi_index& operator++()
+    {
+        next();
+        return *this;
+    }
+
+    multi_index& operator+=(std::size_t n)
+    {
+        increment(n);
+        return *this;
+    }
+
+    private:
+    array m_lens;
+    array m_index;
+};
+
+/**
+ * Walks the elements of lens in order along with their offsets through K sets of strides.
+ * Stepping to the next element adds one precomputed step per stride set, selected by the
+ * outermost dimension that changed, so no offsets are recomputed from the index.
+ */
+template <std::size_t N, std::size_t K>
+struct stride_walker
+{
+    using array   = detail::index_array<N>;
+    using offsets = std::array<std::size_t, K>;
+
+    template <class Lens, class Strides>
+    stride_walker(const Lens& lens, const std::array<Strides, K>& strides, std::size_t start = 0)
+        : m_index(lens)
+    {
+        for(std::size_t k = 0; k < K; k++)
+        {
+            assert(strides[k].size() == lens.size());
+            m_strides[k] = array(lens.size());
+            m_steps[k]   = array(lens.size());
+            std::copy(strides[k].begin(), strides[k].end(), m_strides[k].begin());
+            // The step of dimension d moves it forward by one and rewinds the inner dimensions
+            // from their last element back to zero. Unsigned wraparound cancels out in the sum.
+            std::size_t rewind = 0;
+            for(auto d = lens.size(); d > 0; d--)
+            {
+                m_steps[k][d - 1] = strides[k][d - 1] - rewind;
+                rewind += (lens[d - 1] - 1) * strides[k][d - 1];
+            }
+        }
+        seek(start);
+    }
+
+    const multi_index<N>& index() const { return m_index; }
+
+    const offsets& offset() const { return m_offsets; }
+
+    std::size_t offset(std::size_t k) const { return m_offsets[k]; }
+
+    /// The stride of the innermost dimension for the k-th stride set
+    std::size_t inner_stride(std::size_t k) const
+    {
+        return m_index.size() == 0 ? 0 : m_strides[k][m_index.size() - 1];
+    }
+
+    /// Moves to the i-th element in order
+    void seek(std::size_t i)
+    {
+        m_index.seek(i);
+        for(std::size_t k = 0; k < K; k++)
+        {
+            m_offsets[k] = std::inner_product(
+                m_index.begin(), m_index.end(), m_strides[k].begin(), std::size_t{0});
+        }
+    }
+
+    void next()
+    {
+        if(m_index.size() == 0)
+            return;
+        auto d = m_index.next();
+        for(std::size_t k = 0; k < K; k++)
+            m_offsets[k] += m_steps[k][d];
+    }
+
+    /// Calls f(index, offsets), or f(offsets), for the next n elements
+    template <class F>
+    void for_each(std::size_t n, F f)
+    {
+        for(std::size_t i = 0; i < n; i++)
+        {
+            if constexpr(std::is_invocable<F, const offsets&>{})
+                f(m_offsets);
+            else
+                f(m_index, m_offsets);
+            next();
+        }
+    }
+
+    /// Calls f(offsets, len) for each run of the next n elements along the innermost
+    /// dimension, where the elements of a run are inner_stride apart.
+    template <class F>
+    void for_each_row(std::size_t n, F f)
+    {
+        if(m_index.size() == 0)
+        {
+            if(n > 0)
+                f(m_offsets, std::size_t{1});
+            return;
+        }
+        auto last = m_index.size() - 1;
+        while(n > 0)
+        {
+            auto row = std::min(n, m_index.lens()[last] - m_index[last]);
+            f(m_offsets, row);
+            n -= row;
+            // Move to the last element of the row, so next() carries into the outer dimensions
+            m_index[last] += row - 1;
+            for(std::size_t k = 0; k < K; k++)
+                m_offsets[k] += (row - 1) * m_strides[k][last];
+            next();
+        }
+    }
+
+    private:
+    multi_index<N> m_index;
+    std::array<array, K> m_strides;
+    std::array<array, K> m_steps;
+    offsets m_offsets = {};
+};
+
+/**
+ * Calls f(index, offsets), or f(offsets), for every element of lens in order, where
+ * offsets[k] is the offset of the element through strides[k].
+ */
+template <std::size_t K, class Strides, class F>
+void strided_for_each(const std::vector<std::size_t>& lens,
+                      const std::array<Strides, K>& strides,
+                      F f)
+{
+    auto n = std::accumulate(lens.begin(), lens.end(), std::size_t{1}, std::multiplies<>{});
+    visit_rank(lens.size(), [&](auto rank) {
+        stride_walker<rank, K> w{lens, strides};
+        w.for_each(n, f);
+    });
+}
+
+/**
+ * Same as strided_for_each, but the elements are split into ranges of at least min_grain
+ * elements across the thread pool.
+ */
+template <std::size_t K, class Strides, class F>
+void par_strided_for_each(const std::vector<std::size_t>& lens,
+                          const std::array<Strides, K>& strides,
+                          std::size_t min_grain,
+                          F f)
+{
+    auto n = std::accumulate(lens.begin(), lens.end(), std::size_t{1}, std::multiplies<>{});
+    visit_rank(lens.size(), [&](auto rank) {
+        get_thread_pool().parallel_for(
+            n, min_grain, [&](std::size_t start, std::size_t last, std::size_t) {
+                stride_walker<rank, K> w{lens, strides, start};
+                w.for_each(last - start, f);
+            });
+    });
+}
+
 /**
  * Iterates the given function over the indices from the shape in order.
  */
 template <class F>
 void shape_for_each(const migraphx::shape& s, F f)
 {
-    std::vector<std::size_t> indices(s.lens().size());
+    const auto& lens = s.lens();
+    std::vector<std::size_t> indices(lens.size());
     const auto& index_const_ref = indices;
-    shape ss{s.type(), s.lens()};
-    size_t max = ss.elements();
+    size_t max                  = s.elements();
     for(std::size_t i = 0; i < max; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
         if constexpr(std::is_invocable<F, decltype(index_const_ref), decltype(i)>{})
             f(index_const_ref, i);
         else
             f(index_const_ref);
+        // Carry into the outer dimensions, rather than dividing the index by each stride
+        for(auto d = indices.size(); d > 0; d--)
+        {
+            assert(lens[d - 1] > 0);
+            if(++indices[d - 1] < lens[d - 1] or d == 1)
+                break;
+            indices[d - 1] = 0;
+        }
     }
 }
 
@@ -24,11 +24,8 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_SIMPLE_PAR_FOR_HPP
 #define MIGRAPHX_GUARD_RTGLIB_SIMPLE_PAR_FOR_HPP
 
+#include <migraphx/thread_pool.hpp>
 #include <thread>
-#include <cmath>
-#include <algorithm>
-#include <vector>
-#include <cassert>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -62,48 +59,16 @@ auto thread_invoke(std::size_t i, std::size_t, F f) -> decltype(f(i))
     f(i);
 }
 
-template <class F>
-void simple_par_for_impl(std::size_t n, std::size_t threadsize, F f)
-{
-    if(threadsize <= 1)
-    {
-        for(std::size_t i = 0; i < n; i++)
-            thread_invoke(i, 0, f);
-    }
-    else
-    {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
-#endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::size_t tid  = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work, &tid] {
-            auto result = joinable_thread([=] {
-                std::size_t start = work;
-                std::size_t last  = std::min(n, work + grainsize);
-                for(std::size_t i = start; i < last; i++)
-                {
-                    thread_invoke(i, tid, f);
-                }
-            });
-            work += grainsize;
-            ++tid;
-            return result;
-        });
-        assert(work >= n);
-    }
-}
-
+// Run f(i) or f(i, tid) for each i in [0, n) on the thread pool, where tid is less than the number
+// of threads of the pool plus one
 template <class F>
 void simple_par_for(std::size_t n, std::size_t min_grain, F f)
 {
-    const auto threadsize = std::min<std::size_t>(std::thread::hardware_concurrency(),
-                                                  n / std::max<std::size_t>(1, min_grain));
-    simple_par_for_impl(n, threadsize, f);
+    get_thread_pool().parallel_for(
+        n, min_grain, [&](std::size_t start, std::size_t last, std::size_t tid) {
+            for(std::size_t i = start; i < last; i++)
+                thread_invoke(i, tid, f);
+        });
 }
 
 template <class F>
@@ -0,0 +1,128 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <algorithm>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_impl;
+
+struct MIGRAPHX_EXPORT thread_pool_stats
+{
+    // Number of tasks submitted to the pool
+    std::size_t tasks = 0;
+    // Number of tasks a worker took from the queue of another worker
+    std::size_t steals = 0;
+    // Time the workers spent waiting for tasks, summed over the workers
+    double idle_ms = 0;
+
+    friend MIGRAPHX_EXPORT std::ostream& operator<<(std::ostream& os, const thread_pool_stats& s);
+};
+
+/**
+ * @brief A pool of persistent worker threads
+ *
+ * Each worker owns a queue of tasks. Tasks submitted from a worker are pushed to its own queue
+ * and popped in LIFO order, while idle workers steal from the front of the other queues.
+ *
+ * Parallel loops are run by the calling thread together with the workers, so a loop started
+ * from inside another parallel loop uses the threads that are idle instead of creating more.
+ */
+struct MIGRAPHX_EXPORT thread_pool
+{
+    explicit thread_pool(std::size_t n);
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    /// Queue a task to be run by one of the workers
+    void submit(std::function<void()> f);
+
+    /// Number of worker threads
+    std::size_t size() const;
+
+    /// Returns true when called from one of the workers of this pool
+    bool is_worker() const;
+
+    /// Native handles of the workers, such as to set their affinity
+    std::vector<std::thread::native_handle_type> native_handles() const;
+
+    /**
+     * Call f(start, last, tid) over chunks of [0, n). The chunks are at least min_grain long,
+     * and are sized so each thread gets a few of them to balance the load. At most max_threads
+     * threads are used, including the calling thread, and tid is less than that.
+     */
+    template <class F>
+    void parallel_for(std::size_t n, std::size_t min_grain, std::size_t max_threads, F f)
+    {
+        const std::size_t chunks_per_thread = 4;
+        auto nthreads = std::min(std::max<std::size_t>(max_threads, 1), this->size() + 1);
+        auto nsplits  = nthreads * chunks_per_thread;
+        auto grain    = std::max<std::size_t>({min_grain, 1, (n + nsplits - 1) / nsplits});
+        auto nchunks  = (n + grain - 1) / grain;
+        if(nthreads < 2 or nchunks < 2)
+        {
+            if(n > 0)
+                f(std::size_t{0}, n, std::size_t{0});
+            return;
+        }
+        this->run_chunks(nchunks, nthreads, [&](std::size_t chunk, std::size_t tid) {
+            auto start = chunk * grain;
+            f(start, std::min(n, start + grain), tid);
+        });
+    }
+
+    template <class F>
+    void parallel_for(std::size_t n, std::size_t min_grain, F f)
+    {
+        this->parallel_for(n, min_grain, this->size() + 1, f);
+    }
+
+    thread_pool_stats get_stats() const;
+    void reset_stats();
+
+    private:
+    void run_chunks(std::size_t nchunks,
+                    std::size_t nthreads,
+                    const std::function<void(std::size_t, std::size_t)>& f);
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+/// Returns the process-wide thread pool. Together with the calling thread, it uses
+/// MIGRAPHX_NUM_THREADS threads, or one per core by default.
+MIGRAPHX_EXPORT thread_pool& get_thread_pool();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
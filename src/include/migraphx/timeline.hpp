@@ -0,0 +1,108 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_TIMELINE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_TIMELINE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/shape.hpp>
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct program;
+struct argument;
+struct timeline_impl;
+
+struct MIGRAPHX_EXPORT timeline_event
+{
+    // The operator without its attributes, or "eval" for a whole evaluation
+    std::string name;
+    // Name of the instruction as printed by the program, such as "@3" or "main:@3"
+    std::string instruction;
+    // Index of the thread that ran the instruction, in the order the threads were seen
+    std::size_t tid = 0;
+    // Start and duration in microseconds, relative to the creation of the timeline
+    double start_us    = 0;
+    double duration_us = 0;
+    std::vector<shape> inputs;
+    shape output;
+    // Bytes of the inputs and the output
+    std::size_t bytes = 0;
+};
+
+/**
+ * @brief Records when each instruction runs during evaluation
+ *
+ * A timeline is passed to `program::eval` or `execution_state::eval` through the
+ * `execution_environment`. It can be shared by several evaluations, including ones running
+ * concurrently, and exported as Chrome trace-event JSON that can be opened in Perfetto or
+ * chrome://tracing to see how the instructions overlap across threads.
+ */
+struct MIGRAPHX_EXPORT timeline
+{
+    using clock = std::chrono::steady_clock;
+
+    timeline();
+    timeline(const timeline&)            = delete;
+    timeline& operator=(const timeline&) = delete;
+    ~timeline();
+
+    /// Called before an evaluation of the program, to name its instructions
+    void start(const program& p);
+
+    /// Record an instruction that ran on the calling thread
+    void record(instruction_ref ins,
+                const argument& result,
+                clock::time_point start,
+                clock::time_point stop);
+
+    /// Record a whole evaluation
+    void record_eval(clock::time_point start, clock::time_point stop);
+
+    std::vector<timeline_event> get_events() const;
+
+    void clear();
+
+    /// Write the events as Chrome trace-event JSON
+    void write_chrome_trace(std::ostream& os) const;
+
+    /// Write the events as Chrome trace-event JSON to the file
+    void write_chrome_trace(const std::string& filename) const;
+
+    std::string to_chrome_trace() const;
+
+    private:
+    std::unique_ptr<timeline_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
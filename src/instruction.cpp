@@ -61,6 +61,7 @@ void instruction::replace(const shape& r)
 {
     if(r != result)
     {
+        increment_version();
         result = r;
         for(auto&& ins : output)
         {
@@ -72,6 +73,7 @@ void instruction::replace(const shape& r)
 
 void instruction::replace(operation o)
 {
+    increment_version();
     normalized = false;
     op         = std::move(o);
     recompute_shape();
@@ -81,6 +83,7 @@ void instruction::recompute_shape() { replace(compute_shape(op, arguments, modul
 
 void instruction::clear_arguments()
 {
+    increment_version();
     for(auto&& arg : arguments)
     {
         arg->remove_output(*this);
@@ -227,6 +230,7 @@ void instruction::replace(instruction_ref ins,
 
 void instruction::replace(operation o, const shape& r, std::vector<instruction_ref> args)
 {
+    increment_version();
     normalized = false;
     op         = std::move(o);
     replace(r);
@@ -238,6 +242,7 @@ void instruction::replace(operation o,
                           std::vector<instruction_ref> args,
                           std::vector<module_ref> mdl_args)
 {
+    increment_version();
     op = std::move(o);
     replace(r);
     replace(std::move(args), std::move(mdl_args));
@@ -285,6 +290,7 @@ void instruction::replace(std::vector<instruction_ref> args, std::vector<module_
 
 void instruction::replace_argument(instruction_ref old, instruction_ref new_ins)
 {
+    increment_version();
     assert(std::any_of(arguments.begin(), arguments.end(), equal_to(old)));
     std::replace_if(arguments.begin(), arguments.end(), equal_to(old), new_ins);
     old->remove_output(*this);
@@ -292,6 +298,7 @@ void instruction::replace_argument(instruction_ref old, instruction_ref new_ins)
 
 void instruction::replace_mod_argument(module_ref old, module_ref new_mod)
 {
+    increment_version();
     assert(std::any_of(module_args.begin(), module_args.end(), [&](auto i) { return i == old; }));
     std::replace(module_args.begin(), module_args.end(), old, new_mod);
 }
@@ -353,6 +360,7 @@ argument instruction::eval(bool check_eval) const
 
 void instruction::finalize(context& ctx)
 {
+    increment_version();
     if(has_finalize(this->op))
         this->op.finalize(ctx, this->get_shape(), to_shapes(this->inputs()));
 }
@@ -446,7 +454,11 @@ instruction_ref instruction::get_output_alias(instruction_ref ins, bool shallow)
     return get_output_alias(ins->inputs().at(i));
 }
 
-void instruction::set_normalized(bool value) { normalized = value; }
+void instruction::set_normalized(bool value)
+{
+    increment_version();
+    normalized = value;
+}
 
 bool instruction::is_normalized() const { return normalized; }
 
@@ -468,7 +480,17 @@ operation instruction::normalized_operator() const
 }
 std::size_t instruction::get_target_id() const { return target_id; }
 
-void instruction::set_target_id(std::size_t tid) { this->target_id = tid; }
+void instruction::set_target_id(std::size_t tid)
+{
+    increment_version();
+    this->target_id = tid;
+}
+
+void instruction::increment_version()
+{
+    if(module_version != nullptr)
+        (*module_version)++;
+}
 
 std::vector<shape> to_shapes(const std::vector<instruction_ref>& args)
 {
@@ -55,6 +55,8 @@ struct module_impl
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
+    // Incremented whenever an instruction is added, removed, moved or modified
+    std::size_t version = 0;
 
     bool contains(instruction_ref ins) const
     {
@@ -66,11 +68,14 @@ struct module_impl
     template <class... Ts>
     instruction_ref emplace(instruction_ref pos, Ts&&... xs)
     {
+        version++;
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        adopt(*r);
         return r;
     }
+    void adopt(instruction& ins) { ins.module_version = &version; }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
     {
         return emplace(pos, ins);
@@ -78,6 +83,7 @@ struct module_impl
 
     void clear()
     {
+        version++;
         instructions.clear();
         instruction_set.clear();
         nparams = 0;
@@ -101,12 +107,14 @@ struct module_impl
 
     instruction_ref erase(instruction_ref pos)
     {
+        version++;
         instruction_set.erase(std::addressof(*pos));
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
+        version++;
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
         return instructions.erase(start, last);
     }
@@ -134,6 +142,8 @@ module& module::operator=(module m)
 
 std::string module::name() const { return impl->name; }
 
+std::size_t module::get_version() const { return impl->version; }
+
 void module::set_name(const std::string& name) { impl->name = name; }
 
 bool module::bypass() const { return impl->bypass; }
@@ -383,6 +393,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
 {
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
+    impl->version++;
     impl->instructions.splice(dst, impl->instructions, src);
     return src;
 }
@@ -562,7 +573,9 @@ void module::rename_parameter(instruction_ref ins, const std::string& name)
     auto op      = any_cast<builtin::param>(ins->get_operator());
     op.parameter = name;
     auto outputs = ins->outputs();
-    *ins         = instruction{op, ins->get_shape(), {}};
+    impl->version++;
+    *ins = instruction{op, ins->get_shape(), {}};
+    impl->adopt(*ins);
     for(auto output : outputs)
         ins->add_output(output);
 }
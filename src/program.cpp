@@ -24,6 +24,8 @@
 #include <migraphx/version.h>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_plan.hpp>
+#include <migraphx/execution_state.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/identity.hpp>
@@ -40,16 +42,22 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
 #include <migraphx/supported_segments.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/timeline.hpp>
+#include <condition_variable>
+#include <exception>
 
 #include <iostream>
 #include <queue>
 #include <sstream>
 #include <algorithm>
 #include <set>
+#include <typeinfo>
 #include <unordered_map>
 #include <utility>
 #include <unordered_set>
 #include <map>
+#include <mutex>
 #include <cassert>
 
 namespace migraphx {
@@ -74,6 +82,7 @@ struct program_impl
     std::unordered_map<std::string, module> modules;
     std::vector<context> contexts;
     std::vector<target> targets;
+    std::shared_ptr<const execution_plan> plan;
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -127,6 +136,10 @@ void program::assign(const program& p)
         for(auto ins : iterator_for(mp.second))
             instruction::replace_refs(ins, ins_map, mod_map);
     }
+
+    // The plan refers to the instructions of the other program
+    if(impl->plan != nullptr)
+        impl->plan = std::make_shared<execution_plan>(this->get_main_module());
 }
 
 shape program::get_parameter_shape(std::string name) const
@@ -336,12 +349,29 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->contexts);
     }
+    this->impl->plan = std::make_shared<execution_plan>(this->get_main_module());
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->contexts);
+    this->impl->plan = std::make_shared<execution_plan>(mm);
+}
+
+// Use the plan built during finalize, unless the program has not been compiled. The plan is
+// rebuilt, and cached again, when an instruction was modified afterwards.
+static std::shared_ptr<const execution_plan> get_execution_plan(const program& p,
+                                                                program_impl& impl)
+{
+    auto plan = std::atomic_load(&impl.plan);
+    if(plan == nullptr)
+        return std::make_shared<execution_plan>(p.get_main_module());
+    if(not plan->is_stale())
+        return plan;
+    plan = std::make_shared<execution_plan>(p.get_main_module());
+    std::atomic_store(&impl.plan, plan);
+    return plan;
 }
 
 template <class T>
@@ -426,110 +456,294 @@ void preview_argument(std::ostream& os, const argument& a)
         });
 }
 
+// Evaluate the steps of a module scheduled on several streams. Steps are run as soon as the steps
+// they depend on are finished, by the calling thread and by helpers queued on the thread pool.
 template <class F>
-std::vector<argument> generic_eval(const module* mod,
-                                   std::vector<context>& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   std::unordered_map<instruction_ref, argument> results,
-                                   F trace)
+void eval_concurrent(const execution_plan::module_plan& mp, F f)
 {
-    assert(mod->validate() == mod->end());
-    results.reserve(mod->size() * 2);
-    std::vector<argument> values;
-    values.reserve(16);
-    for(auto ins : iterator_for(*mod))
+    struct dag_state
     {
-        assert(results.find(ins) == results.end());
-        const auto& name = ins->name();
-        if(name == "@literal")
-        {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
-        }
-        else if(name == "@param")
-        {
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
-                        MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
-                    // TODO: may want to check correct number of dimensions and/or was within bounds
-                    if(not ins->get_shape().any_of_dynamic() and
-                       param.get_shape() != ins->get_shape())
-                    {
-                        MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
-                                       "} for parameter: " + param_name +
-                                       " should be: " + to_string(ins->get_shape()));
-                    }
-                    return param;
-                }));
-        }
-        else if(name == "@outline")
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::size_t> pending;
+        std::vector<std::size_t> ready;
+        std::size_t remaining = 0;
+        std::size_t running   = 0;
+        std::exception_ptr error;
+    };
+    // The state is shared with helpers that may only start after the evaluation is finished
+    auto state = std::make_shared<dag_state>();
+    state->pending.resize(mp.steps.size());
+    for(auto i : range(mp.steps.size()))
+    {
+        const auto& s = mp.steps[i];
+        if(s.kind == execution_plan::step_kind::ret)
+            continue;
+        state->remaining++;
+        state->pending[i] = s.npredecessors;
+        if(s.npredecessors == 0)
+            state->ready.push_back(i);
+    }
+    // Reverse so the steps are started in program order
+    std::reverse(state->ready.begin(), state->ready.end());
+
+    auto work = [&mp, &f](dag_state& ds) {
+        std::unique_lock<std::mutex> lock(ds.mutex);
+        for(;;)
         {
-            results.emplace(ins, trace(ins, [&] { return argument{ins->get_shape(), nullptr}; }));
+            ds.cv.wait(lock, [&] {
+                return not ds.ready.empty() or ds.remaining == 0 or ds.error != nullptr;
+            });
+            if(ds.ready.empty())
+                return;
+            auto i = ds.ready.back();
+            ds.ready.pop_back();
+            ds.running++;
+            lock.unlock();
+            std::exception_ptr error;
+            try
+            {
+                f(mp.steps[i]);
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+            lock.lock();
+            ds.running--;
+            if(error != nullptr)
+            {
+                if(ds.error == nullptr)
+                    ds.error = error;
+                ds.ready.clear();
+                ds.cv.notify_all();
+                continue;
+            }
+            ds.remaining--;
+            if(ds.error != nullptr)
+            {
+                ds.cv.notify_all();
+                continue;
+            }
+            const auto& s = mp.steps[i];
+            auto first    = mp.successors.begin() + s.first_successor;
+            std::for_each(first, first + s.nsuccessors, [&](std::size_t j) {
+                if(--ds.pending[j] == 0)
+                    ds.ready.push_back(j);
+            });
+            if(ds.ready.size() > 1 or ds.remaining == 0)
+                ds.cv.notify_all();
         }
-        else if(name == "@return")
-        {
-            std::vector<argument> prog_outputs;
-            std::transform(ins->inputs().begin(),
-                           ins->inputs().end(),
-                           std::back_inserter(prog_outputs),
-                           [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
-                           });
+    };
 
-            return prog_outputs;
-        }
-        else
+    auto& pool   = get_thread_pool();
+    auto helpers = std::min(mp.streams, pool.size() + 1) - 1;
+    for(std::size_t i = 0; i < helpers; i++)
+    {
+        pool.submit([state, work] {
+            // The evaluation may already be finished, in which case there is nothing left to
+            // run and the captured references are not used
+            work(*state);
+        });
+    }
+    work(*state);
+    // Wait for the steps that are still running on the helpers
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->running == 0; });
+    if(state->error != nullptr)
+        std::rethrow_exception(state->error);
+}
+
+// The result slots of one evaluation of a module. The slots of the module itself are stored in
+// this frame, and the slots of the enclosing modules are read through the outer frames, so each
+// evaluation of a submodule gets its own storage even when several run at the same time.
+struct eval_frame
+{
+    argument* data          = nullptr;
+    std::size_t first       = 0;
+    std::size_t size        = 0;
+    const eval_frame* outer = nullptr;
+
+    bool contains(std::size_t slot) const { return slot >= first and slot - first < size; }
+
+    argument& operator[](std::size_t slot) const
+    {
+        assert(contains(slot));
+        return data[slot - first];
+    }
+
+    const argument& get(std::size_t slot) const
+    {
+        if(contains(slot))
+            return data[slot - first];
+        assert(outer != nullptr);
+        return outer->get(slot);
+    }
+};
+
+template <class F>
+std::vector<argument> generic_eval(const execution_plan& plan,
+                                   std::size_t idx,
+                                   std::vector<context>& ctx,
+                                   const std::unordered_map<std::string, argument>& params,
+                                   const eval_frame& results,
+                                   F trace,
+                                   bool concurrent = false)
+{
+    const auto& mp = plan.modules[idx];
+    assert(mp.mod->validate() == mp.mod->end());
+    assert(results.contains(mp.first_slot) or mp.nslots == 0);
+    std::vector<argument> values;
+    values.reserve(plan.max_inputs);
+    auto eval_submodule = [&](const execution_plan::step& s,
+                              module_ref smod,
+                              const std::unordered_map<std::string, argument>& inputs) {
+        auto sub_idx   = plan.get_sub_plan(mp, s, smod);
+        const auto& sp = plan.modules[sub_idx];
+        std::vector<argument> sub_results(sp.nslots);
+        eval_frame frame{sub_results.data(), sp.first_slot, sp.nslots, &results};
+        return generic_eval(plan, sub_idx, ctx, inputs, frame, trace, concurrent);
+    };
+    auto get_inputs = [&](const execution_plan::step& s, std::vector<argument>& args) {
+        auto first = mp.inputs.begin() + s.first_input;
+        args.resize(s.ninputs);
+        std::transform(first, first + s.ninputs, args.begin(), [&](std::size_t slot) {
+            return results.get(slot);
+        });
+    };
+    auto eval_step = [&](const execution_plan::step& s, std::vector<argument>& args) {
+        auto ins = s.ins;
+        assert(ins->inputs().size() == s.ninputs);
+        switch(s.kind)
         {
-            values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
+        case execution_plan::step_kind::literal:
+            results[s.output] = trace(ins, [&] { return ins->get_literal().get_argument(); });
+            break;
+        case execution_plan::step_kind::param:
+            results[s.output] = trace(ins, [&] {
+                const auto& param_name = mp.params[s.index];
+                auto it                = params.find(param_name);
+                if(it == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + param_name);
+                const auto& param = it->second;
+                // TODO: may want to check correct number of dimensions and/or was within bounds
+                if(not ins->get_shape().any_of_dynamic() and param.get_shape() != ins->get_shape())
+                {
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
+                                   "} for parameter: " + param_name +
+                                   " should be: " + to_string(ins->get_shape()));
+                }
+                return param;
+            });
+            break;
+        case execution_plan::step_kind::outline:
+            results[s.output] = trace(ins, [&] { return argument{ins->get_shape(), nullptr}; });
+            break;
+        case execution_plan::step_kind::ret:
+            MIGRAPHX_THROW("Return can not be evaluated as a step");
+        case execution_plan::step_kind::op: {
+            // The slot already holds the buffer of an output bound by the caller
+            if(s.output_buffer and not results[s.output].empty())
+                break;
+            get_inputs(s, args);
             const auto& mod_args = ins->module_inputs();
-            auto module_eval     = [&](module_ref smod,
+            // Only capture two references so the std::function does not need to allocate
+            auto module_eval = [&eval_submodule, &s](
+                                   module_ref smod,
                                    const std::unordered_map<std::string, argument>& inputs) {
-                return generic_eval(smod, ctx, inputs, results, trace);
+                return eval_submodule(s, smod, inputs);
             };
 
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto op = ins->normalized_operator();
-                    if(op.is_context_free())
-                        return op.compute(ins->get_shape(), values, mod_args, module_eval);
-                    if(ins->get_target_id() >= ctx.size())
-                        MIGRAPHX_THROW("No context available for " + op.name());
-                    return op.compute(
-                        ctx[ins->get_target_id()], ins->get_shape(), values, mod_args, module_eval);
-                }));
+            results[s.output] = trace(ins, [&] {
+                if(s.context_free)
+                    return s.op.compute(ins->get_shape(), args, mod_args, module_eval);
+                if(ins->get_target_id() >= ctx.size())
+                    MIGRAPHX_THROW("No context available for " + s.op.name());
+                return s.op.compute(
+                    ctx[ins->get_target_id()], ins->get_shape(), args, mod_args, module_eval);
+            });
+            break;
+        }
         }
-        assert(results.find(ins) != results.end());
         assert(ins->get_shape().any_of_dynamic() or
-               results.at(ins).get_shape() == ins->get_shape());
+               results[s.output].get_shape() == ins->get_shape());
+    };
+    if(concurrent and mp.is_concurrent())
+    {
+        // Accessing a shared context clones it, so make sure that is done before the operators
+        // run concurrently
+        for(auto& c : ctx)
+            c.get_queue();
+        eval_concurrent(mp, [&](const execution_plan::step& s) {
+            std::vector<argument> args;
+            eval_step(s, args);
+        });
+    }
+    else
+    {
+        for(const auto& s : mp.steps)
+        {
+            if(s.kind == execution_plan::step_kind::ret)
+                break;
+            eval_step(s, values);
+        }
+    }
+    if(mp.steps.empty())
+        return {};
+    const auto& last = mp.steps.back();
+    if(last.kind == execution_plan::step_kind::ret)
+    {
+        get_inputs(last, values);
+        return values;
     }
-    return {results.at(std::prev(mod->end()))};
+    return {results[last.output]};
 }
 
 template <class F>
-std::vector<argument> generic_eval(const program& p,
+std::vector<argument> generic_eval(const execution_plan& plan,
+                                   std::size_t idx,
                                    std::vector<context>& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   F trace)
+                                   const std::unordered_map<std::string, argument>& params,
+                                   std::vector<argument>& results,
+                                   F trace,
+                                   bool concurrent = false)
 {
-    const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, trace);
+    assert(results.size() == plan.slots);
+    eval_frame frame{results.data(), 0, results.size(), nullptr};
+    return generic_eval(plan, idx, ctx, params, frame, trace, concurrent);
 }
 
-std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
+template <class F>
+std::vector<argument> generic_eval(const execution_plan& plan,
+                                   std::vector<context>& ctx,
+                                   const std::unordered_map<std::string, argument>& params,
+                                   F trace)
 {
-    auto& contexts = this->impl->contexts;
+    std::vector<argument> results(plan.slots);
+    return generic_eval(plan, 0, ctx, params, results, trace);
+}
 
+// Targets can leave the context empty when none of their operators use it
+static bool has_context(const context& ctx) { return ctx.type_id() != typeid(std::nullptr_t); }
+
+static std::vector<argument> eval_plan(const program& p,
+                                       const std::vector<target>& targets,
+                                       const execution_plan& plan,
+                                       std::vector<context>& contexts,
+                                       std::vector<argument>& results,
+                                       const parameter_map& params,
+                                       execution_environment exec_env,
+                                       const std::vector<argument>& outputs = {})
+{
     auto trace_level = value_of(MIGRAPHX_TRACE_EVAL{});
     std::vector<argument> ret;
 
+    for(auto& ctx : contexts)
+    {
+        if(has_context(ctx))
+            ctx.reset_memory();
+    }
+
     if(exec_env.async)
     {
         assert(contexts.size() == 1);
@@ -540,12 +754,12 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
     {
         std::unordered_map<instruction_ref, std::string> ins_out;
         // get instruction names
-        this->print([&](auto x, auto ins_names) {
+        p.print([&](auto x, auto ins_names) {
             std::stringstream ss;
             instruction::print(ss, x, ins_names);
             ins_out[x] = ss.str();
         });
-        ret = generic_eval(*this, contexts, std::move(params), [&](instruction_ref ins, auto f) {
+        ret = generic_eval(plan, 0, contexts, params, results, [&](instruction_ref ins, auto f) {
             const auto& ctx = contexts[ins->get_target_id()];
             ctx.finish();
             std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
@@ -561,7 +775,7 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
                 migraphx::argument buffer;
                 try
                 {
-                    const target& tgt = this->impl->targets.at(ins->get_target_id());
+                    const target& tgt = targets.at(ins->get_target_id());
                     buffer            = tgt.copy_from(result);
                 }
                 catch(const migraphx::exception&)
@@ -590,9 +804,29 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
             return result;
         });
     }
+    else if(exec_env.trace != nullptr)
+    {
+        auto& t = *exec_env.trace;
+        t.start(p);
+        auto record = [&](instruction_ref ins, auto f) {
+            if(ins->name().front() == '@')
+                return f();
+            auto start  = timeline::clock::now();
+            auto result = f();
+            // Include the time the target takes to complete the instruction
+            if(ins->get_target_id() < contexts.size())
+                contexts[ins->get_target_id()].finish();
+            t.record(ins, result, start, timeline::clock::now());
+            return result;
+        };
+        auto start = timeline::clock::now();
+        ret        = generic_eval(plan, 0, contexts, params, results, record, true);
+        t.record_eval(start, timeline::clock::now());
+    }
     else
     {
-        ret = generic_eval(*this, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
+        ret = generic_eval(
+            plan, 0, contexts, params, results, [&](auto&&, auto f) { return f(); }, true);
     }
 
     if(exec_env.async)
@@ -601,9 +835,191 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
         contexts.front().finish_on(exec_env.queue);
     }
 
+    // Copy the outputs that could not be written to the bound buffer directly
+    for(auto i : range(std::min(outputs.size(), ret.size())))
+    {
+        const auto& output = outputs[i];
+        if(output.empty())
+            continue;
+        if(ret[i].data() != output.data())
+            visit_all(output, ret[i])([&](auto out, auto in) {
+                std::copy(in.begin(), in.end(), out.begin());
+            });
+        ret[i] = output;
+    }
+
+    // The memory of the contexts is reused by the next evaluation, so the other results kept by
+    // the caller are copied out of it
+    for(auto& ctx : contexts)
+    {
+        if(not has_context(ctx))
+            continue;
+        for(auto i : range(ret.size()))
+        {
+            if(i < outputs.size() and not outputs[i].empty())
+                continue;
+            ret[i] = ctx.detach_memory(ret[i]);
+        }
+    }
+
     return ret;
 }
 
+std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
+{
+    auto plan = get_execution_plan(*this, *impl);
+    std::vector<argument> results(plan->slots);
+    return eval_plan(
+        *this, this->impl->targets, *plan, this->impl->contexts, results, params, exec_env);
+}
+
+struct execution_state_impl
+{
+    const program* prog = nullptr;
+    std::shared_ptr<const execution_plan> plan;
+    std::vector<context> contexts;
+    std::vector<argument> results;
+    // Buffers bound to the outputs, and to the output parameters when the program has them
+    std::vector<argument> outputs;
+    parameter_map output_params;
+};
+
+execution_state::execution_state() : impl(std::make_unique<execution_state_impl>()) {}
+
+execution_state::execution_state(const program& p)
+    : impl(std::make_unique<execution_state_impl>())
+{
+    impl->prog = &p;
+    impl->plan = get_execution_plan(p, *p.impl);
+    // The contexts are copy-on-write, so each state gets its own context, and the scratch memory
+    // allocated through it, the first time an operator modifies it
+    impl->contexts = p.impl->contexts;
+    impl->results.resize(impl->plan->slots);
+}
+
+execution_state::execution_state(const execution_state& s)
+    : impl(std::make_unique<execution_state_impl>(*s.impl))
+{
+}
+
+execution_state::execution_state(execution_state&&) noexcept = default;
+
+execution_state& execution_state::operator=(execution_state s)
+{
+    std::swap(s.impl, this->impl);
+    return *this;
+}
+
+execution_state::~execution_state() noexcept = default;
+
+std::vector<argument> execution_state::eval(const parameter_map& params,
+                                            execution_environment exec_env)
+{
+    if(impl->prog == nullptr)
+        MIGRAPHX_THROW("Execution state was not created from a program");
+    const parameter_map* eval_params = &params;
+    parameter_map bound_params;
+    if(not impl->output_params.empty())
+    {
+        bound_params = params;
+        bound_params.insert(impl->output_params.begin(), impl->output_params.end());
+        eval_params = &bound_params;
+    }
+    const auto& main_plan = impl->plan->modules.front();
+    for(auto i : range(impl->outputs.size()))
+    {
+        const auto& output = impl->outputs[i];
+        auto step          = impl->plan->output_steps[i];
+        if(output.empty() or step == main_plan.steps.size())
+            continue;
+        // The allocation can have a different shape than the output it is aliased to
+        const auto& s            = main_plan.steps[step];
+        impl->results[s.output] = argument{s.ins->get_shape(), output.data()};
+    }
+    std::vector<argument> ret;
+    try
+    {
+        ret = eval_plan(*impl->prog,
+                        impl->prog->impl->targets,
+                        *impl->plan,
+                        impl->contexts,
+                        impl->results,
+                        *eval_params,
+                        exec_env,
+                        impl->outputs);
+    }
+    catch(...)
+    {
+        // Don't let a bound buffer be reused by the next evaluation
+        std::fill(impl->results.begin(), impl->results.end(), argument{});
+        throw;
+    }
+    // Release the intermediate results but keep the storage for the next evaluation
+    std::fill(impl->results.begin(), impl->results.end(), argument{});
+    return ret;
+}
+
+static std::string output_parameter_name(const program& p, std::size_t index)
+{
+    return p.get_main_module()->name() + ":#output_" + std::to_string(index);
+}
+
+void execution_state::bind_output(std::size_t index, const argument& output)
+{
+    if(impl->prog == nullptr)
+        MIGRAPHX_THROW("Execution state was not created from a program");
+    auto name  = output_parameter_name(*impl->prog, index);
+    auto names = impl->prog->get_parameter_names();
+    if(contains(names, name))
+    {
+        // The program was compiled with parameters for its outputs
+        auto param_shape = impl->prog->get_parameter_shape(name);
+        if(output.get_shape() != param_shape)
+            MIGRAPHX_THROW("Incorrect shape {" + to_string(output.get_shape()) + "} for output " +
+                           std::to_string(index) + " should be: " + to_string(param_shape));
+        impl->output_params[name] = output;
+        return;
+    }
+    auto output_shapes = impl->prog->get_output_shapes();
+    if(index >= output_shapes.size())
+        MIGRAPHX_THROW("Output index " + std::to_string(index) +
+                       " is out of range, the program has " +
+                       std::to_string(output_shapes.size()) + " outputs");
+    const auto& s = output_shapes[index];
+    if(s.dynamic() or s.type() != output.get_shape().type() or
+       s.lens() != output.get_shape().lens())
+        MIGRAPHX_THROW("Incorrect shape {" + to_string(output.get_shape()) + "} for output " +
+                       std::to_string(index) + " should be: " + to_string(s));
+    if(not output.get_shape().standard())
+        MIGRAPHX_THROW("Output " + std::to_string(index) + " must be bound to a standard shape");
+    if(impl->outputs.size() < output_shapes.size())
+        impl->outputs.resize(output_shapes.size());
+    impl->outputs[index] = output;
+}
+
+void execution_state::bind_output(const std::string& name, const argument& output)
+{
+    if(impl->prog == nullptr)
+        MIGRAPHX_THROW("Execution state was not created from a program");
+    auto prefix = impl->prog->get_main_module()->name() + ":#output_";
+    if(not starts_with(name, prefix) or name.size() == prefix.size() or
+       not std::all_of(name.begin() + prefix.size(), name.end(), &isdigit))
+        MIGRAPHX_THROW("Unknown output: " + name);
+    this->bind_output(std::stoul(name.substr(prefix.size())), output);
+}
+
+void execution_state::finish() const
+{
+    for(const auto& ctx : impl->contexts)
+        ctx.finish();
+}
+
+context& execution_state::get_context() const
+{
+    assert(impl->contexts.size() == 1);
+    return impl->contexts.front();
+}
+
 void program::finish() const
 {
     for(const auto& ctx : this->impl->contexts)
@@ -816,6 +1232,24 @@ std::string perf_group(const operation& op)
     return op.name();
 }
 
+static op_cost perf_cost(instruction_ref ins)
+{
+    auto inputs = to_shapes(ins->inputs());
+    if(ins->get_shape().dynamic() or
+       std::any_of(inputs.begin(), inputs.end(), [](const shape& s) { return s.dynamic(); }))
+        return {};
+    return ins->get_operator().cost(ins->get_shape(), inputs, ins->module_inputs());
+}
+
+static void print_throughput(std::ostream& os, const op_cost& cost, double ms)
+{
+    if(cost.empty() or ms <= 0)
+        return;
+    os << ", " << cost.flops / (ms * 1.0e6) << " GFLOP/s";
+    os << ", " << cost.bytes() / (ms * 1.0e6) << " GB/s";
+    os << ", " << cost.intensity() << " flops/byte";
+}
+
 void program::mark(const parameter_map& params, marker&& m)
 {
     auto& ctx = this->impl->contexts;
@@ -823,8 +1257,9 @@ void program::mark(const parameter_map& params, marker&& m)
     eval(params);
     this->finish();
     // Start marking
+    auto plan = get_execution_plan(*this, *impl);
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+    generic_eval(*plan, ctx, params, [&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
@@ -855,8 +1290,9 @@ void program::perf_report(std::ostream& os,
     }
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
+    auto plan = get_execution_plan(*this, *impl);
     // Fill the map
-    generic_eval(*this, ctx, params, [&](auto ins, auto) {
+    generic_eval(*plan, ctx, params, [&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{ins->get_shape(), nullptr};
     });
@@ -864,7 +1300,7 @@ void program::perf_report(std::ostream& os,
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+        generic_eval(*plan, ctx, params, [&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -890,12 +1326,20 @@ void program::perf_report(std::ostream& os,
     double total_instruction_time = 0.0;
     std::unordered_map<std::string, double> op_times;
     std::unordered_map<std::string, std::size_t> op_n;
+    std::unordered_map<std::string, op_cost> op_costs;
+    std::unordered_map<instruction_ref, op_cost> ins_costs;
+    op_cost total_cost;
     for(auto&& p : ins_vec)
     {
         double avg = common_average(p.second);
-        op_times[perf_group(p.first->get_operator())] += avg;
+        auto group = perf_group(p.first->get_operator());
+        auto cost  = perf_cost(p.first);
+        op_times[group] += avg;
         total_instruction_time += avg;
-        op_n[perf_group(p.first->get_operator())]++;
+        op_n[group]++;
+        op_costs[group] += cost;
+        ins_costs[p.first] = cost;
+        total_cost += cost;
     }
     double calculate_overhead_time    = total_time - total_instruction_time;
     double calculate_overhead_percent = calculate_overhead_time * 100.0 / total_time;
@@ -911,6 +1355,7 @@ void program::perf_report(std::ostream& os,
         double avg     = common_average(ins_vec[ins]);
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         os << ": " << avg << "ms, " << percent << "%";
+        print_throughput(os, ins_costs[ins], avg);
         os << std::endl;
     });
 
@@ -927,8 +1372,9 @@ void program::perf_report(std::ostream& os,
     {
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         double per_ins = avg / nn;
-        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%"
-           << std::endl;
+        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%";
+        print_throughput(os, op_costs.at(name), avg);
+        os << std::endl;
     }
 
     os << std::endl;
@@ -937,6 +1383,12 @@ void program::perf_report(std::ostream& os,
     os << "Rate: " << rate * batch << " inferences/sec" << std::endl;
     os << "Total time: " << total_time << "ms" << std::endl;
     os << "Total instructions time: " << total_instruction_time << "ms" << std::endl;
+    if(not total_cost.empty())
+    {
+        os << "Total GFLOP: " << total_cost.flops / 1.0e9 << ", GB: " << total_cost.bytes() / 1.0e9;
+        print_throughput(os, total_cost, total_instruction_time);
+        os << std::endl;
+    }
     os << "Overhead time: " << overhead_time << "ms"
        << ", " << calculate_overhead_time << "ms" << std::endl;
     os << "Overhead: " << std::round(overhead_percent) << "%"
@@ -1040,7 +1492,7 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->contexts;
-    generic_eval(*this, ctx, std::move(params), [](auto ins, auto&&...) {
+    generic_eval(*get_execution_plan(*this, *impl), ctx, params, [](auto ins, auto&&...) {
         return argument{ins->get_shape(), nullptr};
     });
 }
@@ -26,6 +26,8 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_state.hpp>
+#include <migraphx/timeline.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/quantization.hpp>
@@ -379,17 +381,20 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
                const migraphx::target& t,
                bool offload_copy,
                bool fast_math,
-               bool exhaustive_tune) {
+               bool exhaustive_tune,
+               const std::string& fp16_mode) {
                 migraphx::compile_options options;
                 options.offload_copy    = offload_copy;
                 options.fast_math       = fast_math;
                 options.exhaustive_tune = exhaustive_tune;
+                options.fp16_mode       = fp16_mode;
                 p.compile(t, options);
             },
             py::arg("t"),
             py::arg("offload_copy")    = true,
             py::arg("fast_math")       = true,
-            py::arg("exhaustive_tune") = false)
+            py::arg("exhaustive_tune") = false,
+            py::arg("fp16_mode")       = "native")
         .def("get_main_module", [](const migraphx::program& p) { return p.get_main_module(); })
         .def(
             "create_module",
@@ -424,12 +429,63 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
                      migraphx::any_ptr(reinterpret_cast<void*>(stream), stream_name), true};
                  return p.eval(pm, exec_env);
              })
+        .def("run_with_trace",
+             [](migraphx::program& p, py::dict params, const std::string& trace_file) {
+                 migraphx::parameter_map pm;
+                 for(auto x : params)
+                 {
+                     std::string key      = x.first.cast<std::string>();
+                     py::buffer b         = x.second.cast<py::buffer>();
+                     py::buffer_info info = b.request();
+                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+                 }
+                 migraphx::timeline t;
+                 migraphx::execution_environment exec_env;
+                 exec_env.trace = &t;
+                 auto result    = p.eval(pm, exec_env);
+                 t.write_chrome_trace(trace_file);
+                 return result;
+             })
         .def("sort", &migraphx::program::sort)
         .def("print", [](const migraphx::program& p) { std::cout << p << std::endl; })
         .def("__eq__", std::equal_to<migraphx::program>{})
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
+    py::class_<migraphx::execution_state>(m, "execution_state")
+        .def(py::init<const migraphx::program&>(), py::arg("p"), py::keep_alive<1, 2>())
+        .def("run", [](migraphx::execution_state& s, py::dict params) {
+            migraphx::parameter_map pm;
+            for(auto x : params)
+            {
+                std::string key      = x.first.cast<std::string>();
+                py::buffer b         = x.second.cast<py::buffer>();
+                py::buffer_info info = b.request();
+                pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+            }
+            // Allow other states to run from other python threads
+            py::gil_scoped_release release;
+            return s.eval(pm);
+        })
+        .def(
+            "bind_output",
+            [](migraphx::execution_state& s, std::size_t index, py::buffer b) {
+                py::buffer_info info = b.request();
+                s.bind_output(index, migraphx::argument(to_shape(info), info.ptr));
+            },
+            py::arg("index"),
+            py::arg("output"),
+            py::keep_alive<1, 3>())
+        .def(
+            "bind_output",
+            [](migraphx::execution_state& s, const std::string& name, py::buffer b) {
+                py::buffer_info info = b.request();
+                s.bind_output(name, migraphx::argument(to_shape(info), info.ptr));
+            },
+            py::arg("name"),
+            py::arg("output"),
+            py::keep_alive<1, 3>());
+
     py::class_<migraphx::operation> op(m, "op");
     op.def(py::init([](const std::string& name, py::kwargs kwargs) {
           migraphx::value v = migraphx::value::object{};
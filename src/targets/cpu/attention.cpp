@@ -0,0 +1,219 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/op_cost.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Computes softmax(scale * q * k + mask) * v, for q of [..., m, d], k of [..., d, n], v of
+ * [..., n, dv] and an optional mask of [..., m, n].
+ *
+ * The scores are computed for a block of rows and a block of keys at a time, and the softmax is
+ * accumulated across the key blocks with a running max and sum, so the [m, n] scores are never
+ * stored in memory.
+ */
+struct cpu_attention : auto_register_op<cpu_attention>
+{
+    float scale = 1.0f;
+
+    static constexpr std::size_t row_block = 32;
+    static constexpr std::size_t key_block = 128;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.scale, "scale"));
+    }
+
+    std::string name() const { return "cpu::attention"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes{inputs, *this}.has(3, 4).same_type().same_ndims().min_ndims(2);
+        const auto& q = inputs[0];
+        const auto& k = inputs[1];
+        const auto& v = inputs[2];
+        if(q.type() != shape::float_type)
+            MIGRAPHX_THROW(name() + ": Only float is supported");
+        auto n = q.ndim();
+        if(q.lens()[n - 1] != k.lens()[n - 2] or k.lens()[n - 1] != v.lens()[n - 2])
+            MIGRAPHX_THROW(name() + ": Dimensions of q, k and v do not match");
+        auto scores = q.lens();
+        scores.back() = k.lens().back();
+        if(inputs.size() == 4 and inputs[3].lens() != scores)
+            MIGRAPHX_THROW(name() + ": Mask does not match the scores");
+        auto lens   = q.lens();
+        lens.back() = v.lens().back();
+        return {q.type(), lens};
+    }
+
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        const auto& q = inputs[0];
+        auto d        = q.lens().back();
+        auto scores   = output.elements() / output.lens().back() * inputs[1].lens().back();
+        // Both gemms, and the scale, mask, max, exp and sum of each score
+        double flops = 2.0 * scores * (d + output.lens().back()) + 5.0 * scores;
+        return make_op_cost(flops, output, inputs);
+    }
+
+    static std::size_t batch_offset(const shape& s, const std::vector<std::size_t>& idx)
+    {
+        return std::inner_product(idx.begin(), idx.end(), s.strides().begin(), std::size_t{0});
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& qs = args[0].get_shape();
+        const auto& ks = args[1].get_shape();
+        const auto& vs = args[2].get_shape();
+        bool has_mask  = args.size() == 5;
+        const auto& ms = has_mask ? args[3].get_shape() : qs;
+        auto n         = output_shape.ndim();
+        auto m         = qs.lens()[n - 2];
+        auto d         = qs.lens()[n - 1];
+        auto nk        = ks.lens()[n - 1];
+        auto dv        = vs.lens()[n - 1];
+        std::vector<std::size_t> batch_lens(qs.lens().begin(), qs.lens().end() - 2);
+        batch_lens.push_back(1);
+        shape batch_shape{shape::float_type, batch_lens};
+
+        const auto* q_ptr = args[0].cast<float>();
+        const auto* k_ptr = args[1].cast<float>();
+        const auto* v_ptr = args[2].cast<float>();
+        const auto* m_ptr = has_mask ? args[3].cast<float>() : nullptr;
+        auto* out_ptr     = args.back().cast<float>();
+        // Strides of the rows and columns of each matrix
+        auto qr = qs.strides()[n - 2];
+        auto qc = qs.strides()[n - 1];
+        auto kr = ks.strides()[n - 2];
+        auto kc = ks.strides()[n - 1];
+        auto vr = vs.strides()[n - 2];
+        auto vc = vs.strides()[n - 1];
+        auto mr = ms.strides()[n - 2];
+        auto mc = ms.strides()[n - 1];
+
+        auto row_blocks = (m + row_block - 1) / row_block;
+        ctx.bulk_execute(batch_shape.elements() * row_blocks, 1, [&](auto start, auto last) {
+            std::vector<float> scores(row_block * key_block);
+            std::vector<float> acc(row_block * dv);
+            std::vector<float> row_max(row_block);
+            std::vector<float> row_sum(row_block);
+            for(std::size_t w = start; w < last; w++)
+            {
+                auto b   = w / row_blocks;
+                auto r0  = (w % row_blocks) * row_block;
+                auto rn  = std::min(row_block, m - r0);
+                auto idx = batch_shape.multi(b);
+                idx.pop_back();
+                const auto* q    = q_ptr + batch_offset(qs, idx) + r0 * qr;
+                const auto* k    = k_ptr + batch_offset(ks, idx);
+                const auto* v    = v_ptr + batch_offset(vs, idx);
+                const auto* mask = has_mask ? m_ptr + batch_offset(ms, idx) + r0 * mr : nullptr;
+                auto* out        = out_ptr + b * m * dv + r0 * dv;
+
+                std::fill(acc.begin(), acc.end(), 0.0f);
+                std::fill(row_max.begin(), row_max.end(), -std::numeric_limits<float>::infinity());
+                std::fill(row_sum.begin(), row_sum.end(), 0.0f);
+                for(std::size_t c0 = 0; c0 < nk; c0 += key_block)
+                {
+                    auto cn = std::min(key_block, nk - c0);
+                    for(std::size_t i = 0; i < rn; i++)
+                    {
+                        auto* srow = scores.data() + i * key_block;
+                        std::fill(srow, srow + cn, 0.0f);
+                        for(std::size_t t = 0; t < d; t++)
+                        {
+                            auto x         = q[i * qr + t * qc];
+                            const auto* kt = k + t * kr + c0 * kc;
+                            for(std::size_t j = 0; j < cn; j++)
+                                srow[j] += x * kt[j * kc];
+                        }
+                        for(std::size_t j = 0; j < cn; j++)
+                            srow[j] *= scale;
+                        if(mask != nullptr)
+                        {
+                            const auto* mrow = mask + i * mr + c0 * mc;
+                            for(std::size_t j = 0; j < cn; j++)
+                                srow[j] += mrow[j * mc];
+                        }
+                        auto new_max = std::max(row_max[i], *std::max_element(srow, srow + cn));
+                        // Every key so far is masked out
+                        if(std::isinf(new_max) and new_max < 0)
+                            continue;
+                        auto correction = std::exp(row_max[i] - new_max);
+                        float sum       = 0;
+                        for(std::size_t j = 0; j < cn; j++)
+                        {
+                            srow[j] = std::exp(srow[j] - new_max);
+                            sum += srow[j];
+                        }
+                        row_sum[i] = row_sum[i] * correction + sum;
+                        row_max[i] = new_max;
+                        auto* arow = acc.data() + i * dv;
+                        for(std::size_t t = 0; t < dv; t++)
+                            arow[t] *= correction;
+                        for(std::size_t j = 0; j < cn; j++)
+                        {
+                            auto p           = srow[j];
+                            const auto* vrow = v + (c0 + j) * vr;
+                            for(std::size_t t = 0; t < dv; t++)
+                                arow[t] += p * vrow[t * vc];
+                        }
+                    }
+                }
+                for(std::size_t i = 0; i < rn; i++)
+                {
+                    for(std::size_t t = 0; t < dv; t++)
+                        out[i * dv + t] = acc[i * dv + t] / row_sum[i];
+                }
+            }
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -69,6 +69,14 @@ struct dnnl_binary : dnnl_op<dnnl_binary, dnnl::binary>
         return r;
     }
 
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        inputs = this->trim_post_op_inputs(inputs);
+        return make_op_cost(output.elements(), output, inputs);
+    }
+
     dnnl::binary::desc get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         return {to_dnnl_algo(algo),
@@ -0,0 +1,76 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/cache_dir.hpp>
+#include <cstdlib>
+#include <system_error>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+static fs::path get_user_cache_dir()
+{
+    const char* xdg = std::getenv("XDG_CACHE_HOME"); // NOLINT
+    if(xdg != nullptr and *xdg != '\0')
+        return xdg;
+    const char* home = std::getenv("HOME"); // NOLINT
+    if(home != nullptr and *home != '\0')
+        return fs::path{home} / ".cache";
+    return {};
+}
+
+// Other users could replace the files in a directory they can write to, or that is a link they
+// control
+static bool is_private_dir(const fs::path& dir)
+{
+    struct stat st = {};
+    if(lstat(dir.c_str(), &st) != 0)
+        return false;
+    return S_ISDIR(st.st_mode) and st.st_uid == geteuid() and
+           (st.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+}
+
+fs::path get_cache_dir(const std::string& name, fs::path dir)
+{
+    if(dir.empty())
+    {
+        auto root = get_user_cache_dir();
+        if(root.empty())
+            return {};
+        dir = root / "migraphx" / name;
+    }
+    std::error_code ec;
+    // Only the permissions of a directory created here are changed
+    if(fs::create_directories(dir, ec))
+        fs::permissions(dir, fs::perms::owner_all, ec);
+    if(ec or not is_private_dir(dir))
+        return {};
+    return dir;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,113 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/code_object_op.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_REGISTER_OP(code_object_op);
+
+static std::vector<std::string> detect_cpu_features()
+{
+    std::vector<std::string> result;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+#define MIGRAPHX_CPU_FEATURE(name)        \
+    if(__builtin_cpu_supports(name) != 0) \
+        result.emplace_back(name);
+    MIGRAPHX_CPU_FEATURE("popcnt")
+    MIGRAPHX_CPU_FEATURE("sse3")
+    MIGRAPHX_CPU_FEATURE("ssse3")
+    MIGRAPHX_CPU_FEATURE("sse4.1")
+    MIGRAPHX_CPU_FEATURE("sse4.2")
+    MIGRAPHX_CPU_FEATURE("avx")
+    MIGRAPHX_CPU_FEATURE("avx2")
+    MIGRAPHX_CPU_FEATURE("fma")
+    MIGRAPHX_CPU_FEATURE("bmi")
+    MIGRAPHX_CPU_FEATURE("bmi2")
+    MIGRAPHX_CPU_FEATURE("avx512f")
+    MIGRAPHX_CPU_FEATURE("avx512cd")
+    MIGRAPHX_CPU_FEATURE("avx512vl")
+    MIGRAPHX_CPU_FEATURE("avx512bw")
+    MIGRAPHX_CPU_FEATURE("avx512dq")
+#undef MIGRAPHX_CPU_FEATURE
+#endif
+    return result;
+}
+
+const std::vector<std::string>& get_cpu_features()
+{
+    static const std::vector<std::string> features = detect_cpu_features();
+    return features;
+}
+
+shape code_object_op::compute_shape(std::vector<shape> inputs) const
+{
+    if(inputs != expected_inputs)
+        MIGRAPHX_THROW("Input shapes have changed: [" + to_string_range(expected_inputs) +
+                       "] -> [" + to_string_range(inputs) + "]");
+    return output;
+}
+
+argument
+code_object_op::compute(context& ctx, const shape&, const std::vector<argument>& args) const
+{
+    assert(kernel != nullptr);
+    std::vector<void*> kargs(args.size());
+    std::transform(
+        args.begin(), args.end(), kargs.begin(), [](const argument& a) { return a.data(); });
+    ctx.bulk_execute(output.elements(), 1024, [&](std::size_t start, std::size_t stop) {
+        kernel(start, stop, kargs.data());
+    });
+    return args.back();
+}
+
+void code_object_op::finalize(context&, const shape&, const std::vector<shape>&)
+{
+    assert(not code_object.empty());
+    // Running a kernel compiled for another cpu, such as from a saved program, would crash on an
+    // illegal instruction
+    std::vector<std::string> missing;
+    std::copy_if(features.begin(),
+                 features.end(),
+                 std::back_inserter(missing),
+                 [](const std::string& f) { return not contains(get_cpu_features(), f); });
+    if(not missing.empty())
+        MIGRAPHX_THROW("Kernel " + symbol_name + " was compiled for cpu features not supported " +
+                       "by this cpu: " + join_strings(missing, ", "));
+    dynamic_loader loader{reinterpret_cast<const char*>(code_object.data()), code_object.size()};
+    kernel = loader.get_function<kernel_function>(symbol_name);
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,350 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/cache_dir.hpp>
+#include <migraphx/cpu/code_object_op.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/fileutils.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/optimize_module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/rewrite_quantization.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <system_error>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_KERNEL_CACHE_DIR);
+
+// Host versions of the functions used by the point_op attributes of the operators
+static const char* const pointwise_preamble = R"__migraphx__(
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace migraphx {
+
+#define MIGRAPHX_CPU_UNARY_FUNCTION(name) \
+    template <class T>                   \
+    inline auto name(T x)                \
+    {                                    \
+        return std::name(x);             \
+    }
+
+#define MIGRAPHX_CPU_BINARY_FUNCTION(name) \
+    template <class T, class U>           \
+    inline auto name(T x, U y)            \
+    {                                     \
+        return std::name(x, y);           \
+    }
+
+MIGRAPHX_CPU_UNARY_FUNCTION(acos)
+MIGRAPHX_CPU_UNARY_FUNCTION(acosh)
+MIGRAPHX_CPU_UNARY_FUNCTION(asin)
+MIGRAPHX_CPU_UNARY_FUNCTION(asinh)
+MIGRAPHX_CPU_UNARY_FUNCTION(atan)
+MIGRAPHX_CPU_UNARY_FUNCTION(atanh)
+MIGRAPHX_CPU_UNARY_FUNCTION(ceil)
+MIGRAPHX_CPU_UNARY_FUNCTION(cos)
+MIGRAPHX_CPU_UNARY_FUNCTION(cosh)
+MIGRAPHX_CPU_UNARY_FUNCTION(erf)
+MIGRAPHX_CPU_UNARY_FUNCTION(exp)
+MIGRAPHX_CPU_UNARY_FUNCTION(floor)
+MIGRAPHX_CPU_UNARY_FUNCTION(isinf)
+MIGRAPHX_CPU_UNARY_FUNCTION(isnan)
+MIGRAPHX_CPU_UNARY_FUNCTION(log)
+MIGRAPHX_CPU_UNARY_FUNCTION(nearbyint)
+MIGRAPHX_CPU_UNARY_FUNCTION(sin)
+MIGRAPHX_CPU_UNARY_FUNCTION(sinh)
+MIGRAPHX_CPU_UNARY_FUNCTION(sqrt)
+MIGRAPHX_CPU_UNARY_FUNCTION(tan)
+MIGRAPHX_CPU_UNARY_FUNCTION(tanh)
+MIGRAPHX_CPU_BINARY_FUNCTION(fmod)
+MIGRAPHX_CPU_BINARY_FUNCTION(pow)
+MIGRAPHX_CPU_BINARY_FUNCTION(remainder)
+
+template <class T, class U>
+inline T convert(U x)
+{
+    return static_cast<T>(x);
+}
+
+template <class T>
+inline T abs(T x)
+{
+    return x < T(0) ? -x : x;
+}
+
+template <class T>
+inline auto rsqrt(T x)
+{
+    return 1 / std::sqrt(x);
+}
+
+template <class T, class U>
+inline auto max(T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return type(x) < type(y) ? type(y) : type(x);
+}
+
+template <class T, class U>
+inline auto min(T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return type(y) < type(x) ? type(y) : type(x);
+}
+
+template <class C, class T, class U>
+inline auto where(C cond, T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return cond ? type(x) : type(y);
+}
+
+} // namespace migraphx
+)__migraphx__";
+
+static const char* const pointwise_kernel = R"__migraphx__(
+${preamble}
+
+namespace migraphx {
+
+${function}
+
+} // namespace migraphx
+
+extern "C" void ${kernel}(std::size_t start, std::size_t stop, void* const* args)
+{
+${pointers}
+    for(std::size_t i = start; i < stop; i++)
+        y[${output_index}] = migraphx::pointwise_op(${args});
+}
+)__migraphx__";
+
+static bool is_supported_type(shape::type_t t)
+{
+    return not contains({shape::half_type, shape::fp8e4m3fnuz_type, shape::tuple_type}, t);
+}
+
+bool can_compile_pointwise(const module& pm, const std::vector<shape>& inputs)
+{
+    if(std::any_of(inputs.begin(), inputs.end(), [](const shape& s) {
+           return s.dynamic() or not is_supported_type(s.type());
+       }))
+        return false;
+    return std::all_of(pm.begin(), pm.end(), [](const instruction& ins) {
+        if(not is_supported_type(ins.get_shape().type()))
+            return false;
+        if(starts_with(ins.name(), "@"))
+            return true;
+        // The quantization operators are rewritten to operators with a point_op
+        if(contains({"quantizelinear", "dequantizelinear"}, ins.name()))
+            return true;
+        return ins.get_operator().attributes().contains("point_op");
+    });
+}
+
+// Offset of the element at the standard index i, with the lens and strides baked in so the
+// compiler can strength reduce the divisions
+static std::string generate_index(const shape& s)
+{
+    if(s.standard())
+        return "i";
+    std::vector<std::string> terms;
+    std::size_t n = 1;
+    for(std::size_t d = s.lens().size(); d > 0; d--)
+    {
+        auto len    = s.lens()[d - 1];
+        auto stride = s.strides()[d - 1];
+        if(len != 1 and stride != 0)
+        {
+            std::string idx = n == 1 ? "i" : "(i / " + std::to_string(n) + ")";
+            if(n * len < s.elements())
+                idx = "(" + idx + " % " + std::to_string(len) + ")";
+            if(stride != 1)
+                idx += " * " + std::to_string(stride);
+            terms.push_back(idx);
+        }
+        n *= len;
+    }
+    if(terms.empty())
+        return "0";
+    return join_strings(terms, " + ");
+}
+
+static std::string generate_pointer(const shape& s, const std::string& name, std::size_t i)
+{
+    auto type = shape::cpp_type(s.type());
+    return "    const " + type + "* __restrict " + name + " = static_cast<const " + type +
+           "*>(args[" + std::to_string(i) + "]);";
+}
+
+// The name is also used for the file of the kernel, so only the first operators are named to
+// stay under the limit of the length of file names
+static std::string generate_kernel_name(const module& pm)
+{
+    const std::size_t max_names = 4;
+    std::vector<std::string> names;
+    std::size_t ops = 0;
+    for(const auto& ins : pm)
+    {
+        if(starts_with(ins.name(), "@"))
+            continue;
+        if(ops++ < max_names)
+            names.push_back(to_c_id(ins.name()));
+    }
+    if(ops > max_names)
+        names.push_back(std::to_string(ops) + "ops");
+    names.push_back("kernel");
+    return join_strings(names, "_");
+}
+
+static std::string generate_pointwise(const module& pm)
+{
+    module m = pm;
+    run_passes(m, {rewrite_quantization{}, optimize_module{}});
+    m.sort();
+    cpp_generator g;
+    g.fmap([](const std::string& fname) { return "migraphx::" + fname; });
+    g.fresult(
+        [](const shape& s) { return "migraphx::convert<" + shape::cpp_type(s.type()) + ">"; });
+    g.create_function(
+        g.generate_module(m).set_attributes({"inline"}).set_name("pointwise_op"));
+    return g.str();
+}
+
+// The kernels only use the extensions detected on the host, instead of -march=native, so the
+// code object can be checked against the cpu it is loaded on
+static std::vector<std::string> get_isa_flags()
+{
+    std::vector<std::string> flags;
+#if defined(__x86_64__)
+    flags.emplace_back("-march=x86-64");
+    flags.emplace_back("-mtune=native");
+#endif
+    std::transform(get_cpu_features().begin(),
+                   get_cpu_features().end(),
+                   std::back_inserter(flags),
+                   [](const std::string& f) { return "-m" + f; });
+    return flags;
+}
+
+static std::vector<char> compile_cached(const std::string& src, const std::string& kernel)
+{
+    src_compiler compiler;
+    compiler.flags = {"-std=c++17", "-O3", "-fno-math-errno", "-fPIC", "-shared"};
+    auto isa_flags = get_isa_flags();
+    compiler.flags.insert(compiler.flags.end(), isa_flags.begin(), isa_flags.end());
+    compiler.output = make_shared_object_filename(kernel);
+
+    auto dir = get_cache_dir("cpu-kernels", string_value_of(MIGRAPHX_CPU_KERNEL_CACHE_DIR{}));
+    if(dir.empty())
+        return compiler.compile({src_file{"pointwise.cpp", src}});
+
+    // The flags include the isa, so kernels for another cpu are never read back
+    auto key =
+        compiler.compiler.string() + " " + join_strings(compiler.flags, " ") + "\n" + src + "\n";
+    auto path = dir / (kernel + "_" + std::to_string(std::hash<std::string>{}(key)) + ".kernel");
+    // The file starts with the whole key, so a kernel with the same hash is never loaded
+    if(fs::exists(path))
+    {
+        auto buffer = read_buffer(path);
+        if(buffer.size() >= key.size() and std::equal(key.begin(), key.end(), buffer.begin()))
+            return {buffer.begin() + key.size(), buffer.end()};
+    }
+
+    auto image = compiler.compile({src_file{"pointwise.cpp", src}});
+    // The cache is only an optimization, so the kernel is still used when it can't be written.
+    // It is written to a temporary file first so concurrent compiles never read a partial file.
+    std::vector<char> buffer(key.begin(), key.end());
+    buffer.insert(buffer.end(), image.begin(), image.end());
+    auto tmp = append_extension(path, ".tmp" + std::to_string(std::random_device{}()));
+    write_buffer(tmp, buffer);
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if(ec)
+        fs::remove(tmp, ec);
+    return image;
+}
+
+operation compile_pointwise(const module& pm, const std::vector<shape>& inputs)
+{
+    assert(not inputs.empty());
+    const auto& output = inputs.back();
+    std::vector<shape> args(inputs.begin(), inputs.end() - 1);
+    // Elements can be visited in memory order when every shape has the same layout
+    bool same_layout =
+        output.packed() and
+        std::all_of(args.begin(), args.end(), [&](const auto& s) { return s == output; });
+
+    std::vector<std::string> pointers;
+    std::vector<std::string> names;
+    for(auto i : range(args.size()))
+    {
+        auto name = "p" + std::to_string(i);
+        pointers.push_back(generate_pointer(args[i], name, i));
+        names.push_back(name + "[" + (same_layout ? "i" : generate_index(args[i])) + "]");
+    }
+    auto type = shape::cpp_type(output.type());
+    pointers.push_back("    " + type + "* __restrict y = static_cast<" + type + "*>(args[" +
+                       std::to_string(args.size()) + "]);");
+
+    auto kernel = generate_kernel_name(pm);
+    auto src    = interpolate_string(pointwise_kernel,
+                                  {{"preamble", pointwise_preamble},
+                                   {"function", generate_pointwise(pm)},
+                                   {"kernel", kernel},
+                                   {"pointers", join_strings(pointers, "\n")},
+                                   {"output_index", same_layout ? "i" : generate_index(output)},
+                                   {"args", join_strings(names, ", ")}});
+
+    code_object_op op;
+    op.code_object     = value::binary{compile_cached(src, kernel)};
+    op.symbol_name     = kernel;
+    op.expected_inputs = inputs;
+    op.output          = output;
+    op.features        = get_cpu_features();
+    op.ops             = std::count_if(pm.begin(), pm.end(), [](const instruction& ins) {
+        return not starts_with(ins.name(), "@");
+    });
+    return op;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
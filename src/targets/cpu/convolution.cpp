@@ -35,9 +35,19 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_convolution
-    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>
+template <class Derived, class Op>
+struct dnnl_convolution_base : dnnl_extend_op<Derived, dnnl::convolution_forward, Op>
 {
+    using base = dnnl_extend_op<Derived, dnnl::convolution_forward, Op>;
+    // The dnnl algorithm, which is chosen by tune_ops when tuning is enabled
+    std::string algo = "convolution_auto";
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack_join(base::reflect(self, f), pack(f(self.algo, "algo")));
+    }
+
     std::vector<int> arg_map(int) const
     {
         return {MIGRAPHX_DNNL_PREFIX(ARG_SRC), MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)};
@@ -45,7 +55,8 @@ struct dnnl_convolution
 
     shape adjust_shape(const shape& x, int i, const shape& output) const
     {
-        auto s = base_adjust_shape(x, output);
+        auto s         = this->base_adjust_shape(x, output);
+        const auto& op = this->op;
         if(i == 1 and op.group > 1)
         {
             // TODO: Add support for transposed weights
@@ -62,6 +73,7 @@ struct dnnl_convolution
     dnnl::convolution_forward::desc
     get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
+        const auto& op = this->op;
         // In DNNL dilation is zero-based
         auto dilation = op.dilation;
         std::transform(
@@ -70,7 +82,7 @@ struct dnnl_convolution
         std::vector<size_t> padding_l(op.padding.begin(), op.padding.begin() + kdims);
         std::vector<size_t> padding_r(op.padding.begin() + kdims, op.padding.end());
         return {dnnl::prop_kind::forward_inference,
-                dnnl::algorithm::convolution_auto,
+                to_dnnl_algo(algo),
                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_SRC)),
                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)),
                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)),
@@ -81,6 +93,17 @@ struct dnnl_convolution
     }
 };
 
+struct dnnl_convolution : dnnl_convolution_base<dnnl_convolution, op::convolution>
+{
+};
+
+// Convolution on int8 inputs with int32 accumulation, or a float output when the dequantize
+// scale is folded into the primitive
+struct dnnl_quant_convolution
+    : dnnl_convolution_base<dnnl_quant_convolution, op::quant_convolution>
+{
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -22,6 +22,12 @@
  * THE SOFTWARE.
  */
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/env.hpp>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <sstream>
 
 #if defined(__GNUC__) && __GNUC__ <= 5
 namespace std {
@@ -53,6 +59,41 @@ dnnl_context& get_dnnl_context()
     return ctx;
 }
 
+dnnl::stream& get_dnnl_stream()
+{
+    thread_local dnnl::stream stream{get_dnnl_context().engine}; // NOLINT
+    return stream;
+}
+
+omp_threads_guard limit_dnnl_threads(migraphx::context& ctx)
+{
+    auto* cctx = any_cast<context>(&ctx);
+    if(cctx != nullptr)
+        return cctx->limit_intra_op_threads();
+    return {};
+}
+
+bool has_native_f16()
+{
+#if !defined(MIGRAPHX_ENABLE_ZENDNN) && \
+    (DNNL_VERSION_MAJOR > 2 || (DNNL_VERSION_MAJOR == 2 && DNNL_VERSION_MINOR >= 7))
+    // The isa values are bit masks that include the features of the isas they extend
+    auto isa  = static_cast<unsigned>(dnnl::get_effective_cpu_isa());
+    auto fp16 = static_cast<unsigned>(dnnl::cpu_isa::avx512_core_fp16);
+    return (isa & fp16) == fp16;
+#else
+    return false;
+#endif
+}
+
+std::string get_dnnl_isa()
+{
+    const auto* v = dnnl::version();
+    return std::to_string(v->major) + "." + std::to_string(v->minor) + "." +
+           std::to_string(v->patch) + ":" +
+           std::to_string(static_cast<unsigned>(dnnl::get_effective_cpu_isa()));
+}
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
@@ -95,6 +136,187 @@ dnnl::memory::desc to_dnnl_memory_desc(const shape& s)
     return {to_dnnl_dims(s.lens()), to_dnnl_memory_data_type(s.type()), to_dnnl_dims(s.strides())};
 }
 
+dnnl::memory::desc to_dnnl_any_memory_desc(const shape& s)
+{
+    return {to_dnnl_dims(s.lens()),
+            to_dnnl_memory_data_type(s.type()),
+            dnnl::memory::format_tag::any};
+}
+
+value::binary to_binary(const dnnl::memory::desc& desc)
+{
+    return {reinterpret_cast<const std::uint8_t*>(&desc.data), sizeof(desc.data)};
+}
+
+dnnl::memory::desc from_binary(const value::binary& b)
+{
+    dnnl::memory::desc desc;
+    if(b.size() != sizeof(desc.data))
+        MIGRAPHX_THROW("Invalid size for dnnl memory descriptor: " + std::to_string(b.size()));
+    std::copy(b.begin(), b.end(), reinterpret_cast<std::uint8_t*>(&desc.data));
+    return desc;
+}
+
+argument reorder_weights(const argument& weights,
+                         const dnnl::memory::desc& src_desc,
+                         const dnnl::memory::desc& dst_desc)
+{
+    argument result{shape{shape::uint8_type, {dst_desc.get_size()}}};
+    auto src = to_dnnl_memory(src_desc, weights);
+    auto dst = to_dnnl_memory(dst_desc, result);
+    dnnl::reorder(src, dst).execute(get_dnnl_stream(), src, dst);
+    get_dnnl_stream().wait();
+    return result;
+}
+
+std::function<argument(const argument&)> make_weights_repack(const dnnl::memory::desc& src_desc,
+                                                             const dnnl::memory::desc& dst_desc)
+{
+    struct repacked_weights
+    {
+        std::once_flag flag;
+        argument result;
+    };
+    auto repacked = std::make_shared<repacked_weights>();
+    return [=](const argument& weights) {
+        std::call_once(repacked->flag,
+                       [&] { repacked->result = reorder_weights(weights, src_desc, dst_desc); });
+        return repacked->result;
+    };
+}
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DNNL_CACHE_CAPACITY)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_DNNL_CACHE)
+
+std::ostream& operator<<(std::ostream& os, const dnnl_cache_stats& s)
+{
+    os << "hits: " << s.hits << ", misses: " << s.misses << ", evictions: " << s.evictions
+       << ", size: " << s.size << "/" << s.capacity;
+    return os;
+}
+
+std::string dnnl_cache_key(const std::string& name,
+                           const value& v,
+                           const std::unordered_map<int, dnnl::memory::desc>& m)
+{
+    std::stringstream ss;
+    ss << name << v;
+    // Order the descriptors by their argument so the key does not depend on the hash order
+    std::vector<int> args;
+    std::transform(m.begin(), m.end(), std::back_inserter(args), [](const auto& p) {
+        return p.first;
+    });
+    std::sort(args.begin(), args.end());
+    for(auto arg : args)
+    {
+        auto b = to_binary(m.at(arg));
+        ss << ':' << arg << ':';
+        ss.write(reinterpret_cast<const char*>(b.data()), b.size());
+    }
+    return ss.str();
+}
+
+namespace {
+// Least recently used cache of primitives shared by all programs in the process
+struct dnnl_cache
+{
+    using entry = std::pair<std::string, std::shared_ptr<const void>>;
+
+    std::mutex mutex;
+    std::list<entry> entries;
+    std::unordered_map<std::string, std::list<entry>::iterator> lookup;
+    dnnl_cache_stats stats;
+
+    dnnl_cache() { stats.capacity = value_of(MIGRAPHX_DNNL_CACHE_CAPACITY{}, 1024); }
+
+    std::shared_ptr<const void> find(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = lookup.find(key);
+        if(it == lookup.end())
+        {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    std::shared_ptr<const void> insert(const std::string& key, std::shared_ptr<const void> x)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Another thread could have created the same primitive while the lock was released
+        auto it = lookup.find(key);
+        if(it != lookup.end())
+            return it->second->second;
+        if(stats.capacity == 0)
+            return x;
+        entries.emplace_front(key, std::move(x));
+        lookup[key] = entries.begin();
+        shrink();
+        return entries.front().second;
+    }
+
+    void shrink()
+    {
+        while(entries.size() > stats.capacity)
+        {
+            lookup.erase(entries.back().first);
+            entries.pop_back();
+            stats.evictions++;
+        }
+        stats.size = entries.size();
+    }
+};
+
+dnnl_cache& get_dnnl_cache()
+{
+    static dnnl_cache cache{}; // NOLINT
+    return cache;
+}
+} // namespace
+
+std::shared_ptr<const void>
+dnnl_cache_lookup(const std::string& key,
+                  const std::function<std::shared_ptr<const void>()>& create)
+{
+    auto& cache = get_dnnl_cache();
+    auto result = cache.find(key);
+    if(result != nullptr)
+        return result;
+    // Create the primitive without holding the lock since it can take a while
+    result = cache.insert(key, create());
+    if(enabled(MIGRAPHX_TRACE_DNNL_CACHE{}))
+        std::cout << "dnnl cache miss: " << key.substr(0, key.find('{')) << " ("
+                  << get_dnnl_cache_stats() << ")" << std::endl;
+    return result;
+}
+
+dnnl_cache_stats get_dnnl_cache_stats()
+{
+    auto& cache = get_dnnl_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.stats;
+}
+
+void clear_dnnl_cache()
+{
+    auto& cache = get_dnnl_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.entries.clear();
+    cache.lookup.clear();
+    cache.stats.size = 0;
+}
+
+void set_dnnl_cache_capacity(std::size_t n)
+{
+    auto& cache = get_dnnl_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.stats.capacity = n;
+    cache.shrink();
+}
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a)
 {
     return {desc, get_dnnl_context().engine, a.data()};
@@ -58,6 +58,14 @@ struct dnnl_eltwise : dnnl_op<dnnl_eltwise, dnnl::eltwise_forward>
         return r;
     }
 
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        inputs = this->trim_post_op_inputs(inputs);
+        return make_op_cost(output.elements(), output, inputs);
+    }
+
     dnnl::eltwise_forward::desc get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         return {dnnl::prop_kind::forward_inference,
@@ -51,7 +51,8 @@ MIGRAPHX_PRED_MATCHER(without_post_ops, instruction_ref ins)
 
 bool workaround_dnnl_broken_post_ops(const operation& op, const operation& post_op)
 {
-    if(contains({"dnnl::dot", "dnnl::convolution"}, op.name()))
+    if(contains({"dnnl::dot", "dnnl::convolution", "dnnl::quant_dot", "dnnl::quant_convolution"},
+                op.name()))
         return true;
     auto pv = post_op.to_value();
     if(not pv.at("post_ops").empty())
@@ -24,7 +24,12 @@
 #include <migraphx/config.hpp>
 #include <migraphx/context.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/op/convert.hpp>
 #include <migraphx/op/gather.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -42,34 +47,60 @@ struct cpu_gather : auto_register_op<cpu_gather>
     std::string name() const { return "cpu::" + op.name(); }
     shape compute_shape(std::vector<shape> inputs) const
     {
+        auto alloc = inputs.back();
         // Compensate for allocation
         inputs.pop_back();
         check_shapes(inputs, *this).standard();
-        return migraphx::compute_shape(op, inputs);
+        // The rows are converted to the type of the allocation when a convert is fused
+        return migraphx::compute_shape(op, inputs).with_type(alloc.type());
     }
 
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
-        std::size_t nelements = output_shape.elements();
-        auto lens             = args[0].get_shape().lens();
-        auto axis_dim_size    = lens[op.axis];
-        lens[op.axis]         = args[1].get_shape().elements();
-        shape out_comp{output_shape.type(), lens};
+        const auto& lens   = args[0].get_shape().lens();
+        auto axis_dim_size = lens[op.axis];
+        // The input is standard, so the elements after the axis are a contiguous row
+        auto outer = std::accumulate(
+            lens.begin(), lens.begin() + op.axis, std::size_t{1}, std::multiplies<>{});
+        auto inner = std::accumulate(
+            lens.begin() + op.axis + 1, lens.end(), std::size_t{1}, std::multiplies<>{});
+        auto nindices = args[1].get_shape().elements();
+        auto rows     = outer * nindices;
+        // Each chunk copies at least a few kilobytes
+        auto grain = std::max<std::size_t>(4096 / (inner * output_shape.type_size() + 1), 1);
 
-        visit_all(args.back(), args[0])([&](auto output, auto input) {
-            args[1].visit([&](auto indices) {
-                const auto* indices_ptr = indices.data();
-                auto* output_ptr        = output.data();
-                ctx.bulk_execute(nelements, 1024, [=](auto start, auto end) {
-                    for(auto i = start; i < end; i++)
-                    {
-                        auto idx      = out_comp.multi(i);
-                        auto in_index = indices_ptr[idx[op.axis]];
-                        in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
-                        idx[op.axis]  = in_index;
-                        output_ptr[i] = input(idx.begin(), idx.end());
-                    }
+        args[1].visit([&](auto indices) {
+            const auto* indices_ptr = indices.data();
+            auto row_start          = [=](std::size_t r) {
+                auto in_index = indices_ptr[r % nindices];
+                in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                return ((r / nindices) * axis_dim_size + in_index) * inner;
+            };
+            if(output_shape.type() == args[0].get_shape().type())
+            {
+                auto type_size = output_shape.type_size();
+                auto bytes     = inner * type_size;
+                const auto* in = args[0].data();
+                auto* out      = args.back().data();
+                ctx.bulk_execute(rows, grain, [=](auto start, auto end) {
+                    for(auto r = start; r < end; r++)
+                        std::memcpy(out + r * bytes, in + row_start(r) * type_size, bytes);
+                });
+                return;
+            }
+            auto f = op::convert{output_shape.type()}.apply();
+            args.back().visit([&](auto output) {
+                args[0].visit([&](auto input) {
+                    auto* out      = output.data();
+                    const auto* in = input.data();
+                    ctx.bulk_execute(rows, grain, [=](auto start, auto end) {
+                        for(auto r = start; r < end; r++)
+                        {
+                            const auto* row = in + row_start(r);
+                            std::transform(row, row + inner, out + r * inner, f);
+                        }
+                    });
                 });
             });
         });
@@ -0,0 +1,109 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_CPU_CODE_OBJECT_OP_HPP
+#define MIGRAPHX_GUARD_CPU_CODE_OBJECT_OP_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/value.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/op_cost.hpp>
+#include <migraphx/cpu/export.h>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct context;
+
+/// Returns the instruction set extensions of the host cpu that generated kernels can be compiled
+/// for. The names are the suffixes of the compiler flags enabling them, such as avx2 for -mavx2.
+MIGRAPHX_CPU_EXPORT const std::vector<std::string>& get_cpu_features();
+
+/// Runs a kernel from a shared object compiled with the host compiler. The kernel computes the
+/// elements in [start, stop) of the output, which is the last argument.
+struct MIGRAPHX_CPU_EXPORT code_object_op
+{
+    using kernel_function = void(std::size_t, std::size_t, void* const*);
+
+    value::binary code_object{};
+    std::string symbol_name = "";
+    std::vector<shape> expected_inputs{};
+    shape output{};
+    // The instruction set extensions the code object was compiled for
+    std::vector<std::string> features{};
+    // Number of operators computed for each element, which is used to estimate the flops
+    std::size_t ops = 0;
+    std::function<kernel_function> kernel = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.code_object, "code_object"),
+                    f(self.symbol_name, "symbol_name"),
+                    f(self.expected_inputs, "expected_inputs"),
+                    f(self.output, "output"),
+                    f(self.features, "features"),
+                    f(self.ops, "ops"));
+    }
+
+    value attributes() const { return {{"group", group()}}; }
+
+    std::string group() const { return "cpu::code_object::" + symbol_name; }
+
+    std::string name() const { return "cpu::code_object"; }
+    shape compute_shape(std::vector<shape> inputs) const;
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const;
+    void finalize(context&, const shape&, const std::vector<shape>&);
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    op_cost cost(const shape& output_shape, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return make_op_cost(ops * output_shape.elements(), output_shape, inputs);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const code_object_op& op)
+    {
+        os << op.name() << "[";
+        os << "code_object=" << op.code_object.size() << ",";
+        os << "symbol_name=" << op.symbol_name;
+        os << "]";
+        return os;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_CPU_CODE_OBJECT_OP_HPP
@@ -25,23 +25,115 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/arena.hpp>
+#include <migraphx/env.hpp>
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/cpu/numa.hpp>
 #include <migraphx/cpu/parallel.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/cpu/export.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_STREAMS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_NUMA_NODES)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_NUMA_REPLICATE)
+
 struct context
 {
+    context(std::size_t n = value_of(MIGRAPHX_CPU_STREAMS{}, 1))
+        : streams(std::max<std::size_t>(n, 1)),
+          numa_nodes(parse_numa_nodes(string_value_of(MIGRAPHX_CPU_NUMA_NODES{})))
+    {
+    }
+    // The scratch memory and the arena are not copied, so copies of the context can be used to
+    // evaluate the same program concurrently
+    context(const context& other) : streams(other.streams), numa_nodes(other.numa_nodes) {}
+    context& operator=(const context& other)
+    {
+        streams    = other.streams;
+        numa_nodes = other.numa_nodes;
+        preallocations.clear();
+        return *this;
+    }
+    context(context&& other) noexcept
+        : streams(other.streams),
+          numa_nodes(std::move(other.numa_nodes)),
+          preallocations(std::move(other.preallocations))
+    {
+    }
+    context& operator=(context&& other) noexcept
+    {
+        streams        = other.streams;
+        numa_nodes     = std::move(other.numa_nodes);
+        preallocations = std::move(other.preallocations);
+        return *this;
+    }
+    ~context() = default;
+
     void finish() const {}
 
+    void reset_memory() const { memory.reset(); }
+
+    argument detach_memory(const argument& result) const { return memory.detach(result); }
+
+    /// Allocates the buffers that are not placed in the scratch memory
+    arena& get_arena() { return memory; }
+
+    /// Number of streams that instructions are scheduled on, which is the number of operators
+    /// that can be evaluated concurrently
+    std::size_t get_streams() const { return streams; }
+
+    /// Number of threads an operator can use, so that concurrent operators do not oversubscribe
+    /// the cores
+    std::size_t get_intra_op_threads() const
+    {
+        return std::max<std::size_t>(max_threads() / streams, 1);
+    }
+
+    /// Limit the threads used by dnnl primitives executed on the calling thread, until the
+    /// returned guard is destroyed
+    omp_threads_guard limit_intra_op_threads() const
+    {
+        if(streams > 1)
+            return omp_threads_guard{get_intra_op_threads()};
+        return {};
+    }
+
+    /// The numa nodes the threads are pinned to, which is empty when they are not pinned
+    const std::vector<std::size_t>& get_numa_nodes() const { return numa_nodes; }
+
+    /// Whether literals are copied to each numa node, so operators read the local copy
+    bool replicate_literals() const
+    {
+        return numa_nodes.size() > 1 and enabled(MIGRAPHX_CPU_NUMA_REPLICATE{});
+    }
+
+    argument get_preallocation(const std::string& id, const shape& s)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = preallocations.find(id);
+        // With a numa policy, the pages are first touched by the threads that use them
+        if(it == preallocations.end() and numa_nodes.empty())
+            it = preallocations.emplace(id, argument{s}).first;
+        else if(it == preallocations.end())
+            it = preallocations.emplace(id, allocate_first_touch(s, get_intra_op_threads())).first;
+        assert(it->second.get_shape() == s);
+        return it->second;
+    }
+
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
     {
-        cpu::parallel_for(n, min_grain, f);
+        cpu::parallel_for(n, min_grain, get_intra_op_threads(), f);
     }
 
     template <class F>
@@ -49,6 +141,14 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    std::size_t streams = 1;
+    std::vector<std::size_t> numa_nodes;
+    std::mutex mutex;
+    std::unordered_map<std::string, argument> preallocations;
+    // The arena is synchronized, so it can be reset through a shared context
+    mutable arena memory;
 };
 
 } // namespace cpu
@@ -29,9 +29,14 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/value.hpp>
+#include <migraphx/serialize.hpp>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <migraphx/errors.hpp>
 #include <migraphx/assert.hpp>
+#include <migraphx/cpu/parallel.hpp>
 #ifdef MIGRAPHX_ENABLE_ZENDNN
 #include <zendnn.hpp>
 #else
@@ -59,6 +64,19 @@ struct dnnl_context
 
 dnnl_context& get_dnnl_context();
 
+// Stream for the calling thread, since primitives can be executed concurrently
+dnnl::stream& get_dnnl_stream();
+
+// Limit the threads dnnl uses on the calling thread when operators are evaluated concurrently,
+// until the returned guard is destroyed
+omp_threads_guard limit_dnnl_threads(migraphx::context& ctx);
+
+// Whether the CPU has native fp16 arithmetic that dnnl can use
+bool has_native_f16();
+
+// Identifies the dnnl version and the isa it dispatches to, since tuned results depend on both
+std::string get_dnnl_isa();
+
 dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t);
 
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n);
@@ -71,8 +89,52 @@ inline dnnl::memory::dims to_dnnl_dims(R&& r)
 
 dnnl::memory::desc to_dnnl_memory_desc(const shape& s);
 
+// Descriptor that lets the primitive choose the layout
+dnnl::memory::desc to_dnnl_any_memory_desc(const shape& s);
+
+value::binary to_binary(const dnnl::memory::desc& desc);
+
+dnnl::memory::desc from_binary(const value::binary& b);
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a);
 
+// Reorder constant weights from the src layout to the dst layout
+argument reorder_weights(const argument& weights,
+                         const dnnl::memory::desc& src_desc,
+                         const dnnl::memory::desc& dst_desc);
+
+// Returns a function that reorders the weights it is passed, which are constant, on the first
+// call and returns the same reordered buffer afterwards
+std::function<argument(const argument&)> make_weights_repack(const dnnl::memory::desc& src_desc,
+                                                             const dnnl::memory::desc& dst_desc);
+
+struct dnnl_cache_stats
+{
+    std::size_t hits      = 0;
+    std::size_t misses    = 0;
+    std::size_t evictions = 0;
+    std::size_t size      = 0;
+    std::size_t capacity  = 0;
+
+    friend std::ostream& operator<<(std::ostream& os, const dnnl_cache_stats& s);
+};
+
+// Key for the primitive cache from the op name, its attributes and the memory descriptors
+std::string dnnl_cache_key(const std::string& name,
+                           const value& v,
+                           const std::unordered_map<int, dnnl::memory::desc>& m);
+
+// Lookup an entry in the process-wide primitive cache, and call create when it is missing
+std::shared_ptr<const void>
+dnnl_cache_lookup(const std::string& key,
+                  const std::function<std::shared_ptr<const void>()>& create);
+
+dnnl_cache_stats get_dnnl_cache_stats();
+
+void clear_dnnl_cache();
+
+void set_dnnl_cache_capacity(std::size_t n);
+
 dnnl::memory to_dnnl_memory(const argument& a);
 
 dnnl::algorithm to_dnnl_algo(const std::string& name);
@@ -108,12 +170,28 @@ template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
+    // When the weights are prepacked, the weights input is an opaque buffer in the layout that
+    // the primitive prefers, and weights_shape is the shape the buffer was packed from.
+    // packed_desc is the layout of the buffer, and packed_isa is the dnnl version and isa it was
+    // packed with. The weights are reordered when the primitive prefers another layout.
+    bool prepacked = false;
+    shape weights_shape{};
+    value::binary packed_desc{};
+    std::string packed_isa{};
+    // Scale applied to the accumulator of int8 primitives, which then write a float output. It
+    // is empty when the output is not scaled.
+    std::vector<float> output_scales{};
     std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"),
+                    f(self.prepacked, "prepacked"),
+                    f(self.weights_shape, "weights_shape"),
+                    f(self.packed_desc, "packed_desc"),
+                    f(self.packed_isa, "packed_isa"),
+                    f(self.output_scales, "output_scales"));
     }
 
     template <class Self, class F>
@@ -246,10 +324,31 @@ struct dnnl_op : auto_register_op<Derived>
         assert(m.size() >= inputs.size());
         for(int i = 0; i < inputs.size(); i++)
         {
-            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i, output_shape));
+            if(prepacked and m[i] == MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS))
+                result[m[i]] =
+                    to_dnnl_any_memory_desc(self.adjust_shape(weights_shape, i, output_shape));
+            else
+                result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i, output_shape));
         }
         return result;
     }
+    // Index of the input that is passed as the weights of the primitive
+    std::size_t get_weights_arg(std::size_t input_size) const
+    {
+        auto m  = create_arg_map(input_size);
+        auto it = std::find(m.begin(), m.end(), MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        if(it == m.end())
+            MIGRAPHX_THROW("Prepacked weights are not supported by " +
+                           static_cast<const Derived&>(*this).name());
+        return it - m.begin();
+    }
+    // Replace the prepacked weights with the shape they were packed from
+    std::vector<shape> unpack_weights(std::vector<shape> inputs) const
+    {
+        if(prepacked)
+            inputs.at(get_weights_arg(inputs.size())) = weights_shape;
+        return inputs;
+    }
     dnnl::primitive_attr
     get_primitive_attr(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
@@ -274,6 +373,8 @@ struct dnnl_op : auto_register_op<Derived>
                 MIGRAPHX_THROW("Unknown post op algo: " + op.algo);
         });
         result.set_post_ops(po);
+        if(not output_scales.empty())
+            result.set_output_scales(0, output_scales);
         return result;
     }
     template <class T>
@@ -282,16 +383,36 @@ struct dnnl_op : auto_register_op<Derived>
     {
         return typename Primitive::primitive_desc(desc, attr, get_dnnl_context().engine);
     }
-    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    auto create_primitive_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         const auto& self = static_cast<const Derived&>(*this);
         auto desc        = self.get_desc(m);
         auto attr        = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
-        auto pd          = self.get_primitive_desc(desc, attr);
-        return Primitive(pd);
+        return self.get_primitive_desc(desc, attr);
+    }
+    struct cached_primitive
+    {
+        typename Primitive::primitive_desc pd;
+        Primitive prim;
+    };
+    // Identical layers share the primitive, so it is only created once in the process
+    std::shared_ptr<const cached_primitive>
+    get_cached_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        auto key         = dnnl_cache_key(self.name(), migraphx::to_value(self), m);
+        return std::static_pointer_cast<const cached_primitive>(dnnl_cache_lookup(key, [&] {
+            auto pd = create_primitive_desc(m);
+            return std::make_shared<const cached_primitive>(cached_primitive{pd, Primitive(pd)});
+        }));
+    }
+    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        return get_cached_primitive(m)->prim;
     }
     argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
     {
+        auto threads = limit_dnnl_threads(ctx);
         return execute(ctx, args);
     }
 
@@ -303,10 +424,19 @@ struct dnnl_op : auto_register_op<Derived>
     {
         // Compensate for allocation
         inputs.pop_back();
-        auto md        = to_memory_desc(output_shape, inputs);
-        auto prim      = get_primitive(md);
-        auto impl_name = impl(prim);
-        return {{"impl", impl_name}};
+        auto md      = to_memory_desc(output_shape, inputs);
+        auto cached  = get_cached_primitive(md);
+        value result = {{"impl", impl(cached->prim)}};
+        // Report both layouts so the weights can be reordered when they are prepacked
+        if(prepacked)
+        {
+            const auto& self = static_cast<const Derived&>(*this);
+            auto i           = get_weights_arg(inputs.size());
+            auto w           = self.adjust_shape(weights_shape, i, output_shape);
+            result["weights_desc"]   = to_binary(to_dnnl_memory_desc(w));
+            result["prepacked_desc"] = to_binary(cached->pd.weights_desc());
+        }
+        return result;
     }
 
     void finalize(context&, const shape& output_shape, std::vector<shape> inputs)
@@ -316,8 +446,22 @@ struct dnnl_op : auto_register_op<Derived>
         const auto& self = static_cast<const Derived&>(*this);
         auto name        = self.name();
         auto md          = to_memory_desc(output_shape, inputs);
-        auto prim        = get_primitive(md);
+        auto cached      = get_cached_primitive(md);
+        auto prim        = cached->prim;
         auto arg_lookup  = create_arg_map(inputs.size());
+        // The prepacked weights use the layout the primitive chose, which can be different when
+        // the program is loaded on another machine
+        auto exec_md = md;
+        // Set when the weights have to be reordered to the layout of the primitive
+        std::function<argument(const argument&)> repack = nullptr;
+        if(prepacked)
+        {
+            auto weights_desc = cached->pd.weights_desc();
+            auto packed       = from_binary(packed_desc);
+            if(packed != weights_desc)
+                repack = make_weights_repack(packed, weights_desc);
+            exec_md[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] = weights_desc;
+        }
 #ifndef NDEBUG
         auto prim_attr = get_primitive_attr(md);
 #endif
@@ -387,10 +531,15 @@ struct dnnl_op : auto_register_op<Derived>
 #endif
             std::unordered_map<int, dnnl::memory> m;
             m[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
-                to_dnnl_memory(md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
+                to_dnnl_memory(exec_md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
             for(int i = 0; i < args.size() - 1; i++)
-                m[arg_lookup[i]] = to_dnnl_memory(md.at(arg_lookup[i]), args[i]);
-            prim.execute(get_dnnl_context().stream, m);
+            {
+                if(repack != nullptr and arg_lookup[i] == MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS))
+                    m[arg_lookup[i]] = to_dnnl_memory(exec_md.at(arg_lookup[i]), repack(args[i]));
+                else
+                    m[arg_lookup[i]] = to_dnnl_memory(exec_md.at(arg_lookup[i]), args[i]);
+            }
+            prim.execute(get_dnnl_stream(), m);
             return args.back();
         });
     }
@@ -426,11 +575,20 @@ struct dnnl_extend_op : dnnl_op<Derived, Primitive>
         // Compensate for allocation
         inputs.pop_back();
         self.required(check_shapes(inputs, self));
-        auto r = migraphx::compute_shape(op, this->trim_post_op_inputs(inputs));
+        auto r = migraphx::compute_shape(
+            op, this->trim_post_op_inputs(this->unpack_weights(inputs)));
+        if(not this->output_scales.empty())
+            r = r.with_type(shape::float_type);
         // Call to get_primitive to make sure an algo is available
         this->get_primitive(this->to_memory_desc(r, inputs));
         return r;
     }
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::cost(op, output, this->trim_post_op_inputs(this->unpack_weights(inputs)));
+    }
 };
 
 } // namespace cpu
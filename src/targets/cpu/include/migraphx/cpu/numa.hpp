@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_CPU_NUMA_HPP
+#define MIGRAPHX_GUARD_CPU_NUMA_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/cpu/export.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// The cpus of each numa node. A machine without numa information is a single node.
+MIGRAPHX_CPU_EXPORT const std::vector<std::vector<std::size_t>>& get_numa_nodes();
+
+/// The numa node of the cpu the calling thread is running on
+MIGRAPHX_CPU_EXPORT std::size_t get_current_numa_node();
+
+/// Parse a list of nodes such as "0,2-3"
+MIGRAPHX_CPU_EXPORT std::vector<std::size_t> parse_numa_nodes(const std::string& s);
+
+/// Pin the workers of the thread pool, and the OpenMP threads of the calling thread, to the cpus
+/// of the nodes. The threads the workers create afterwards inherit the affinity, while the calling
+/// thread and the other threads of the application are left alone. Pinning the same nodes again
+/// does nothing.
+MIGRAPHX_CPU_EXPORT void pin_workers_to_numa_nodes(const std::vector<std::size_t>& nodes);
+
+/// Run f on a thread pinned to the node, so the pages f touches first are placed on the node
+MIGRAPHX_CPU_EXPORT void run_on_numa_node(std::size_t node, const std::function<void()>& f);
+
+/// Allocate a zeroed buffer whose pages are first touched by the threads of the parallel loops,
+/// instead of the calling thread, so they are spread over the nodes of the threads using them
+MIGRAPHX_CPU_EXPORT argument allocate_first_touch(const shape& s, std::size_t nthreads);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_CPU_NUMA_HPP
@@ -25,10 +25,10 @@
 #define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_PARALLEL_HPP
 
 // #define MIGRAPHX_DISABLE_OMP
-#include <cmath>
 #include <migraphx/config.hpp>
+#include <migraphx/thread_pool.hpp>
 #ifdef MIGRAPHX_DISABLE_OMP
-#include <migraphx/par_for.hpp>
+#include <thread>
 #else
 
 #ifdef __clang__
@@ -47,64 +47,55 @@ inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
 #ifdef MIGRAPHX_DISABLE_OMP
-
 inline std::size_t max_threads() { return std::thread::hardware_concurrency(); }
+#else
+// OpenMP is still used by dnnl, so its thread count is the number of threads available
+inline std::size_t max_threads() { return omp_get_max_threads(); }
+#endif
 
-template <class F>
-void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
+/// Sets the number of OpenMP threads used by the calling thread, and restores the previous number
+/// when it is destroyed, so that the threads of the pool don't keep the limit for later work
+struct omp_threads_guard
 {
-    if(threadsize <= 1)
+    omp_threads_guard() = default;
+    explicit omp_threads_guard(std::size_t n)
     {
-        f(std::size_t{0}, n);
+#ifndef MIGRAPHX_DISABLE_OMP
+        previous = omp_get_max_threads();
+        omp_set_num_threads(static_cast<int>(n));
+#else
+        (void)n;
+#endif
     }
-    else
+    omp_threads_guard(const omp_threads_guard&)            = delete;
+    omp_threads_guard& operator=(const omp_threads_guard&) = delete;
+    ~omp_threads_guard()
     {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
+#ifndef MIGRAPHX_DISABLE_OMP
+        if(previous > 0)
+            omp_set_num_threads(previous);
 #endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work] {
-            auto result =
-                joinable_thread([=]() mutable { f(work, std::min(n, work + grainsize)); });
-            work += grainsize;
-            return result;
-        });
-        // cppcheck-suppress unsignedLessThanZero
-        assert(work >= n);
     }
-}
-#else
 
-inline std::size_t max_threads() { return omp_get_max_threads(); }
+#ifndef MIGRAPHX_DISABLE_OMP
+    private:
+    int previous = 0;
+#endif
+};
 
 template <class F>
-void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
+void parallel_for(std::size_t n, std::size_t min_grain, std::size_t max_threadsize, F f)
 {
-    if(threadsize <= 1)
-    {
-        f(std::size_t{0}, n);
-    }
-    else
-    {
-        std::size_t grainsize = std::ceil(static_cast<double>(n) / threadsize);
-#pragma omp parallel for num_threads(threadsize) schedule(static, 1) private(grainsize, n)
-        for(std::size_t tid = 0; tid < threadsize; tid++)
-        {
-            std::size_t work = tid * grainsize;
-            f(work, std::min(n, work + grainsize));
-        }
-    }
+    get_thread_pool().parallel_for(
+        n, min_grain, max_threadsize, [&](std::size_t start, std::size_t last, std::size_t) {
+            f(start, last);
+        });
 }
-#endif
+
 template <class F>
 void parallel_for(std::size_t n, std::size_t min_grain, F f)
 {
-    const auto threadsize = std::min<std::size_t>(max_threads(), n / min_grain);
-    parallel_for_impl(n, threadsize, f);
+    parallel_for(n, min_grain, max_threads(), f);
 }
 
 template <class F>
@@ -0,0 +1,61 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_CPU_PERFDB_HPP
+#define MIGRAPHX_GUARD_CPU_PERFDB_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/cpu/export.h>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/sqlite.hpp>
+#include <migraphx/value.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// The tuned solutions of problems for the dnnl version and isa in use, stored in a sqlite
+/// database. It is opened once, so a pass looks up all of its problems with the same connection.
+struct MIGRAPHX_CPU_EXPORT perfdb
+{
+    /// Open the database at the path. An empty path defaults to MIGRAPHX_CPU_PERFDB, or to
+    /// perf.db in the cache directory of the user. Nothing is stored when there is no such path.
+    explicit perfdb(fs::path p = {});
+
+    optional<value> find(const std::string& name, const value& problem);
+
+    void store(const std::string& name, const value& problem, const value& solution);
+
+    private:
+    fs::path path;
+    sqlite db;
+    bool opened   = false;
+    bool writable = false;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_CPU_PERFDB_HPP
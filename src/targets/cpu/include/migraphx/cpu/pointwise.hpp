@@ -364,6 +364,13 @@ struct cpu_unary : reduce_dims_base, auto_register_op<cpu_unary<Op>>
     {
         return shapes.size() - 1;
     }
+
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::cost(op, output, inputs);
+    }
 };
 
 template <class Op>
@@ -405,6 +412,13 @@ struct cpu_binary : reduce_dims_base, auto_register_op<cpu_binary<Op>>
     {
         return shapes.size() - 1;
     }
+
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::cost(op, output, inputs);
+    }
 };
 
 } // namespace cpu
@@ -0,0 +1,300 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/lower_rnn.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/op/gru.hpp>
+#include <migraphx/op/lstm.hpp>
+#include <migraphx/op/rnn.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct rnn_kind
+{
+    std::string kind;
+    // The dnnl algorithm of the activation, which is only used by the vanilla rnn
+    std::string activation;
+    op::rnn_direction direction;
+    // The onnx gate used for each of the dnnl gates
+    std::vector<std::size_t> gates;
+};
+
+static std::vector<std::string> get_names(const std::vector<operation>& ops)
+{
+    std::vector<std::string> result;
+    std::transform(ops.begin(), ops.end(), std::back_inserter(result), [](const auto& op) {
+        return op.name();
+    });
+    return result;
+}
+
+// The activations are only supported when each direction uses the fixed activations of dnnl
+static bool uses_activations(const std::vector<operation>& actv_funcs,
+                             const std::vector<std::string>& activations)
+{
+    auto names = get_names(actv_funcs);
+    if(names.empty())
+        return true;
+    if(names.size() % activations.size() != 0)
+        return false;
+    for(std::size_t i = 0; i < names.size(); i++)
+    {
+        if(names[i] != activations[i % activations.size()])
+            return false;
+    }
+    return true;
+}
+
+static optional<rnn_kind> get_rnn_kind(const operation& op)
+{
+    if(op.name() == "lstm")
+    {
+        auto lstm = any_cast<op::lstm>(op);
+        if(lstm.clip != 0 or lstm.input_forget != 0)
+            return nullopt;
+        if(not uses_activations(lstm.actv_funcs, {"sigmoid", "tanh", "tanh"}))
+            return nullopt;
+        // The gates are iofc in onnx and ifco in dnnl
+        return rnn_kind{"lstm", "", lstm.direction, {0, 2, 3, 1}};
+    }
+    if(op.name() == "gru")
+    {
+        auto gru = any_cast<op::gru>(op);
+        if(gru.clip != 0)
+            return nullopt;
+        if(not uses_activations(gru.actv_funcs, {"sigmoid", "tanh"}))
+            return nullopt;
+        if(gru.linear_before_reset != 0)
+            return rnn_kind{"lbr_gru", "", gru.direction, {0, 1, 2}};
+        return rnn_kind{"gru", "", gru.direction, {0, 1, 2}};
+    }
+    if(op.name() == "rnn")
+    {
+        auto rnn = any_cast<op::rnn>(op);
+        if(rnn.clip != 0)
+            return nullopt;
+        static const std::unordered_map<std::string, std::string> algos = {
+            {"tanh", "eltwise_tanh"}, {"relu", "eltwise_relu"}, {"sigmoid", "eltwise_logistic"}};
+        auto names = get_names(rnn.actv_funcs);
+        if(names.empty())
+            names = {"tanh"};
+        if(not contains(algos, names.front()))
+            return nullopt;
+        if(not std::all_of(
+               names.begin(), names.end(), [&](const auto& n) { return n == names.front(); }))
+            return nullopt;
+        return rnn_kind{"rnn", algos.at(names.front()), rnn.direction, {0}};
+    }
+    return nullopt;
+}
+
+static bool is_defined(const std::vector<instruction_ref>& args, std::size_t i)
+{
+    return args.size() > i and not args[i]->is_undefined();
+}
+
+// The whole sequence is computed at once, so all the sequence lengths must be the full length
+static bool has_full_seq_lens(instruction_ref seq_lens, std::size_t seq_len)
+{
+    if(not seq_lens->can_eval())
+        return false;
+    bool result = true;
+    seq_lens->eval().visit([&](auto lens) {
+        result = std::all_of(lens.begin(), lens.end(), [&](auto l) {
+            return l == static_cast<decltype(l)>(seq_len);
+        });
+    });
+    return result;
+}
+
+// Reorder the weights of [directions, gates * hidden, k] to the ldigo layout of dnnl, which is
+// [directions, k, gates, hidden] here since there is a single layer
+static literal pack_weights(const argument& w, const std::vector<std::size_t>& gates)
+{
+    auto lens       = w.get_shape().lens();
+    auto directions = lens[0];
+    auto hidden     = lens[1] / gates.size();
+    auto k          = lens[2];
+    std::vector<float> result(directions * k * gates.size() * hidden);
+    w.visit([&](auto v) {
+        std::size_t i = 0;
+        for(std::size_t d = 0; d < directions; d++)
+            for(std::size_t j = 0; j < k; j++)
+                for(auto g : gates)
+                    for(std::size_t h = 0; h < hidden; h++)
+                        result[i++] = v(d, g * hidden + h, j);
+    });
+    return literal{shape{shape::float_type, {directions, k, gates.size(), hidden}}, result};
+}
+
+// Combine the input and recurrent biases of [directions, 2 * gates * hidden] to [directions,
+// gates, hidden]. The linear before reset gru keeps the recurrent bias of the last gate
+// separate as an extra gate.
+static literal pack_bias(const optional<argument>& b,
+                         const std::vector<std::size_t>& gates,
+                         std::size_t directions,
+                         std::size_t hidden,
+                         bool lbr)
+{
+    auto ngates = gates.size() + (lbr ? 1 : 0);
+    std::vector<float> result(directions * ngates * hidden);
+    if(b.has_value())
+    {
+        auto offset = gates.size() * hidden;
+        b->visit([&](auto v) {
+            std::size_t i = 0;
+            for(std::size_t d = 0; d < directions; d++)
+            {
+                for(auto g : gates)
+                {
+                    for(std::size_t h = 0; h < hidden; h++)
+                    {
+                        auto wb = v(d, g * hidden + h);
+                        auto rb = v(d, offset + g * hidden + h);
+                        if(lbr and g == gates.back())
+                            result[i++] = wb;
+                        else
+                            result[i++] = wb + rb;
+                    }
+                }
+                if(not lbr)
+                    continue;
+                for(std::size_t h = 0; h < hidden; h++)
+                    result[i++] = v(d, offset + gates.back() * hidden + h);
+            }
+        });
+    }
+    return literal{shape{shape::float_type, {directions, ngates, hidden}}, result};
+}
+
+static instruction_ref insert_contiguous(module& m, instruction_ref ins, instruction_ref x)
+{
+    if(x->get_shape().standard())
+        return x;
+    return m.insert_instruction(ins, make_op("contiguous"), x);
+}
+
+// Slice out the hidden state of one direction at one timestep, as [1, batch, hidden]
+static instruction_ref
+insert_hidden_state(module& m, instruction_ref ins, instruction_ref y, std::size_t t, std::size_t d)
+{
+    auto h = m.insert_instruction(
+        ins,
+        make_op("slice", {{"axes", {0, 1}}, {"starts", {t, d}}, {"ends", {t + 1, d + 1}}}),
+        y);
+    return m.insert_instruction(ins, make_op("squeeze", {{"axes", {0}}}), h);
+}
+
+void lower_rnn::apply(module& m) const
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(not contains({"rnn", "gru", "lstm"}, ins->name()))
+            continue;
+        if(ins->get_shape().dynamic() or ins->get_shape().type() != shape::float_type)
+            continue;
+        auto kind = get_rnn_kind(ins->get_operator());
+        if(not kind.has_value())
+            continue;
+        auto args       = ins->inputs();
+        auto seq_len    = args[0]->get_shape().lens()[0];
+        auto batch      = args[0]->get_shape().lens()[1];
+        auto directions = args[2]->get_shape().lens()[0];
+        auto hidden     = args[2]->get_shape().lens()[2];
+        bool is_lstm    = kind->kind == "lstm";
+        if(not args[1]->can_eval() or not args[2]->can_eval())
+            continue;
+        if(is_defined(args, 3) and not args[3]->can_eval())
+            continue;
+        if(is_defined(args, 4) and not has_full_seq_lens(args[4], seq_len))
+            continue;
+        // Peepholes are not supported
+        if(is_lstm and is_defined(args, 7))
+            continue;
+        // The last cell state is not an output of the primitive
+        if(std::any_of(ins->outputs().begin(), ins->outputs().end(), [](auto output) {
+               return output->name() == "rnn_last_cell_output";
+           }))
+            continue;
+
+        optional<argument> b = nullopt;
+        if(is_defined(args, 3))
+            b = args[3]->eval();
+        auto w    = m.add_literal(pack_weights(args[1]->eval(), kind->gates));
+        auto r    = m.add_literal(pack_weights(args[2]->eval(), kind->gates));
+        auto bias = m.add_literal(
+            pack_bias(b, kind->gates, directions, hidden, kind->kind == "lbr_gru"));
+
+        // The initial states default to zero
+        shape state_shape{shape::float_type, {directions, batch, hidden}};
+        auto initial_state = [&](std::size_t i) {
+            if(is_defined(args, i))
+                return insert_contiguous(m, ins, args[i]);
+            return m.add_literal(literal{state_shape, std::vector<float>(state_shape.elements())});
+        };
+        std::vector<instruction_ref> inputs = {
+            insert_contiguous(m, ins, args[0]), w, r, bias, initial_state(5)};
+        if(is_lstm)
+            inputs.push_back(initial_state(6));
+        auto y = m.replace_instruction(ins,
+                                       make_op("dnnl::rnn",
+                                               {{"kind", kind->kind},
+                                                {"activation", kind->activation},
+                                                {"direction", kind->direction}}),
+                                       inputs);
+
+        // The last hidden state of the forward direction is at the last timestep, and the one
+        // of the reverse direction is at the first timestep
+        auto outputs = y->outputs();
+        for(auto output : outputs)
+        {
+            if(output->name() != "rnn_last_hs_output")
+                continue;
+            std::vector<instruction_ref> states;
+            for(std::size_t d = 0; d < directions; d++)
+            {
+                bool reverse = kind->direction == op::rnn_direction::reverse or d == 1;
+                states.push_back(
+                    insert_hidden_state(m, output, y, reverse ? 0 : seq_len - 1, d));
+            }
+            if(states.size() == 1)
+                m.replace_instruction(output, states.front());
+            else
+                m.replace_instruction(output, make_op("concat", {{"axis", 0}}), states);
+        }
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -49,6 +49,11 @@
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/fuse_pointwise.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
@@ -65,6 +70,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_CPU_POINTWISE_JIT)
+
 template <typename T>
 T zero(const T&)
 {
@@ -155,8 +162,14 @@ struct cpu_op
     }
     std::string name() const { return "cpu::op"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return op.cost(output, inputs);
+    }
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
+        arena_scope scope{ctx.get_arena()};
         return op.compute(output_shape, args);
     }
     value to_value() const
@@ -296,6 +309,16 @@ struct cpu_apply
         }
     }
 
+    // dnnl only has int8 kernels for signed weights, so other types use the reference operator
+    void extend_int8_op(const std::string& op_name, const std::string& dnnl_name)
+    {
+        apply_map.emplace(op_name, [=](instruction_ref ins) {
+            if(ins->inputs().at(1)->get_shape().type() != shape::int8_type)
+                return ins;
+            return replace(ins, make_op(dnnl_name, ins->get_operator().to_value()));
+        });
+    }
+
     template <class M>
     auto fuse_match(M matcher, const operation& op, const std::vector<std::string>& bind_inputs)
     {
@@ -311,6 +334,106 @@ struct cpu_apply
         });
     }
 
+    // Fold the scale of a dequantize into the output scale of the int8 primitive
+    auto fuse_output_scale() const
+    {
+        auto quant   = match::name("quant_dot", "quant_convolution")(match::used_once()).bind("q");
+        auto convert = match::name("convert")(match::arg(0)(quant), match::used_once());
+        return match::make_match_finder(
+            match::name("mul")(match::either_arg(0, 1)(
+                convert, match::skip_broadcasts(match::has_same_value().bind("scale")))),
+            [=](auto&, const auto& r) {
+                auto ins  = r.result;
+                auto q    = r.instructions["q"];
+                auto name = "dnnl::" + q->name();
+                if(not has_op(name) or ins->get_shape().type() != shape::float_type or
+                   q->inputs().at(1)->get_shape().type() != shape::int8_type)
+                    return;
+                float scale = 1.0f;
+                r.instructions["scale"]->get_literal().visit([&](auto s) { scale = s.front(); });
+                auto v             = q->get_operator().to_value();
+                v["output_scales"] = migraphx::to_value(std::vector<float>{scale});
+                auto inputs        = q->inputs();
+                inputs.push_back(this->insert_allocation(ins, ins->get_shape()));
+                modl->replace_instruction(ins, make_op(name, v), inputs);
+            });
+    }
+
+    // Convert the rows while they are gathered, such as for quantized embedding tables
+    auto fuse_gather_convert() const
+    {
+        auto gather = match::name("gather")(match::used_once(), match::static_shape()).bind("g");
+        return match::make_match_finder(
+            match::name("convert")(match::arg(0)(gather)), [=](auto&, const auto& r) {
+                auto ins = r.result;
+                auto g   = r.instructions["g"];
+                auto op  = make_op("cpu::gather", g->get_operator().to_value());
+                this->replace(ins, op, g->inputs());
+            });
+    }
+
+    struct attention_scores
+    {
+        instruction_ref gemm;
+        float scale = 1.0f;
+    };
+
+    // Match dot(q, k), or mul(dot(q, k), scale) where the scale is a constant scalar
+    static std::vector<attention_scores> find_attention_scores(instruction_ref ins)
+    {
+        if(ins->outputs().size() != 1)
+            return {};
+        if(ins->name() == "dot")
+            return {{ins}};
+        if(ins->name() != "mul")
+            return {};
+        for(auto i : range(2))
+        {
+            auto gemm  = ins->inputs()[i];
+            auto scale = read_scalar<float>(ins->inputs()[1 - i]);
+            if(gemm->name() == "dot" and gemm->outputs().size() == 1 and not scale.empty())
+                return {{gemm, scale.front()}};
+        }
+        return {};
+    }
+
+    // Fuse softmax(scale * dot(q, k) + mask) * v into a kernel that does not store the scores
+    auto fuse_attention() const
+    {
+        auto softmax = match::name("softmax")(match::used_once()).bind("sm");
+        return match::make_match_finder(
+            match::name("dot")(match::arg(0)(softmax)), [=](auto&, const auto& r) {
+                auto ins  = r.result;
+                auto sm   = r.instructions["sm"];
+                auto x    = sm->inputs().front();
+                auto axis = sm->get_operator().to_value()["axis"].template to<std::size_t>();
+                if(axis != x->get_shape().ndim() - 1)
+                    return;
+                std::vector<instruction_ref> mask;
+                if(x->name() == "add" and x->outputs().size() == 1)
+                {
+                    auto a = x->inputs()[0];
+                    auto b = x->inputs()[1];
+                    if(find_attention_scores(a).empty())
+                        std::swap(a, b);
+                    mask = {b};
+                    x    = a;
+                }
+                auto scores = find_attention_scores(x);
+                if(scores.empty())
+                    return;
+                auto inputs = scores.front().gemm->inputs();
+                inputs.push_back(ins->inputs()[1]);
+                inputs.insert(inputs.end(), mask.begin(), mask.end());
+                if(std::any_of(inputs.begin(), inputs.end(), [](auto i) {
+                       return i->get_shape().type() != shape::float_type;
+                   }))
+                    return;
+                this->replace(
+                    ins, make_op("cpu::attention", {{"scale", scores.front().scale}}), inputs);
+            });
+    }
+
     void init()
     {
         extend_dnnl_algos("dnnl::binary",
@@ -346,13 +469,17 @@ struct cpu_apply
 #ifndef MIGRAPHX_ENABLE_ZENDNN
         extend_op("convolution_backwards", "dnnl::convolution_backwards");
         extend_op("dot", "dnnl::dot");
+        extend_int8_op("quant_dot", "dnnl::quant_dot");
 #endif
+        extend_int8_op("quant_convolution", "dnnl::quant_convolution");
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
         extend_op("logsoftmax", "dnnl::logsoftmax");
         extend_op("lrn", "dnnl::lrn");
         extend_op("softmax", "dnnl::softmax");
         extend_op("sub", "cpu::sub");
+        // lower_rnn already replaced the rnns, so only the allocation of the output is added
+        extend_op("dnnl::rnn", "dnnl::rnn");
 
         extend_op("im2col", "cpu::im2col", false);
         extend_op("leaky_relu", "cpu::leaky_relu", false);
@@ -360,10 +487,9 @@ struct cpu_apply
         extend_op("rnn_var_sl_last_output", "cpu::rnn_var_sl_last_output", false);
     }
 
-    void apply()
+    // Fuse the patterns that have a dnnl primitive before the pointwise operators are fused
+    void apply_fusions()
     {
-        init();
-        // Apply fusion matchers first
         match::find_matches(*modl,
                             fuse_match(match::gelu_erf(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_erf"}}),
@@ -371,7 +497,20 @@ struct cpu_apply
                             fuse_match(match::gelu_tanh(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_tanh"}}),
                                        {"x"}),
-                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}));
+                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}),
+                            fuse_output_scale(),
+                            fuse_attention(),
+                            fuse_gather_convert());
+    }
+
+    void apply()
+    {
+        init();
+        for(auto it : iterator_for(*modl))
+        {
+            if(it->name() == "pointwise")
+                apply_pointwise(it);
+        }
         // Apply these operators first so the inputs can be const folded
         for(auto it : iterator_for(*modl))
         {
@@ -405,6 +544,56 @@ struct cpu_apply
         }
     }
 
+    // Fused modules, and operators without a dnnl or cpu implementation, are compiled into a
+    // kernel. Other single operators are inlined back so they are lowered like before fusion.
+    instruction_ref apply_pointwise(instruction_ref ins) const
+    {
+        auto* pm = ins->module_inputs().front();
+        auto ops = std::count_if(pm->begin(), pm->end(), [](const instruction& pins) {
+            return not starts_with(pins.name(), "@");
+        });
+        auto inputs = to_shapes(ins->inputs());
+        inputs.push_back(ins->get_shape());
+        auto last = std::prev(pm->end())->inputs().front();
+        if(ops == 1 and apply_map.count(last->name()) > 0)
+            return inline_pointwise(ins);
+        if(not can_compile_pointwise(*pm, inputs))
+            return inline_pointwise(ins);
+        operation op;
+        try
+        {
+            op = compile_pointwise(*pm, inputs);
+        }
+        catch(const std::exception&)
+        {
+            // The host compiler is not available on every deployment, so the operators are
+            // lowered one by one instead
+            return inline_pointwise(ins);
+        }
+        return replace(ins, op);
+    }
+
+    instruction_ref inline_pointwise(instruction_ref ins) const
+    {
+        auto* pm    = ins->module_inputs().front();
+        auto pnames = pm->get_parameter_names();
+        std::sort(pnames.begin(), pnames.end());
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        for(auto i : range(pnames.size()))
+            map_ins[pm->get_parameter(pnames[i])] = ins->inputs()[i];
+        // Scalars were folded into the module as literals, so broadcast them back to the output
+        for(auto pins : iterator_for(*pm))
+        {
+            if(pins->name() != "@literal")
+                continue;
+            auto l        = modl->add_literal(pins->get_literal());
+            map_ins[pins] = modl->insert_instruction(
+                ins, make_op("multibroadcast", {{"out_lens", ins->get_shape().lens()}}), l);
+        }
+        auto r = modl->insert_instructions(ins, pm, map_ins);
+        return modl->replace_instruction(ins, r.front());
+    }
+
     instruction_ref apply_pow(instruction_ref ins) const
     {
         auto beta = read_scalar<float>(ins->inputs()[1]);
@@ -457,7 +646,14 @@ struct cpu_apply
     }
 };
 
-void lowering::apply(module& m) const { cpu_apply{&m}.apply(); }
+void lowering::apply(module_pass_manager& mpm) const
+{
+    cpu_apply a{&mpm.get_module()};
+    a.apply_fusions();
+    if(not enabled(MIGRAPHX_DISABLE_CPU_POINTWISE_JIT{}))
+        mpm.run_pass(fuse_pointwise{});
+    a.apply();
+}
 
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,190 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Parse a list in the format of the kernel, such as "0-3,8-11"
+static std::vector<std::size_t> parse_list(const std::string& s)
+{
+    std::vector<std::size_t> result;
+    for(const auto& r : split_string(trim(s), ','))
+    {
+        if(r.empty())
+            continue;
+        auto dash  = r.find('-');
+        auto first = std::stoul(r.substr(0, dash));
+        auto last  = dash == std::string::npos ? first : std::stoul(r.substr(dash + 1));
+        for(auto i = first; i <= last; i++)
+            result.push_back(i);
+    }
+    return result;
+}
+
+// The size sysfs reports is a page, not the length of the contents, so the file is read as a stream
+static std::string read_sysfs(const fs::path& p)
+{
+    std::ifstream is{p};
+    std::string line;
+    std::getline(is, line);
+    return line;
+}
+
+const std::vector<std::vector<std::size_t>>& get_numa_nodes()
+{
+    static const auto result = [] {
+        std::vector<std::vector<std::size_t>> nodes;
+        const fs::path root{"/sys/devices/system/node"};
+        std::error_code ec;
+        for(const auto& entry : fs::directory_iterator{root, ec})
+        {
+            auto name = entry.path().filename().string();
+            if(not starts_with(name, "node") or name.size() == 4 or
+               not std::all_of(name.begin() + 4, name.end(), [](unsigned char c) {
+                   return std::isdigit(c);
+               }))
+                continue;
+            auto i = std::stoul(name.substr(4));
+            if(i >= nodes.size())
+                nodes.resize(i + 1);
+            nodes[i] = parse_list(read_sysfs(entry.path() / "cpulist"));
+        }
+        if(nodes.empty())
+        {
+            nodes.emplace_back(std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+            std::iota(nodes.front().begin(), nodes.front().end(), 0);
+        }
+        return nodes;
+    }();
+    return result;
+}
+
+std::size_t get_current_numa_node()
+{
+    static const auto cpu_nodes = [] {
+        std::vector<std::size_t> result;
+        const auto& nodes = get_numa_nodes();
+        for(std::size_t node = 0; node < nodes.size(); node++)
+        {
+            for(auto c : nodes[node])
+            {
+                if(c >= result.size())
+                    result.resize(c + 1);
+                result[c] = node;
+            }
+        }
+        return result;
+    }();
+    auto c = sched_getcpu();
+    if(c < 0 or static_cast<std::size_t>(c) >= cpu_nodes.size())
+        return 0;
+    return cpu_nodes[c];
+}
+
+std::vector<std::size_t> parse_numa_nodes(const std::string& s)
+{
+    auto result = parse_list(s);
+    for(auto node : result)
+    {
+        if(node >= get_numa_nodes().size() or get_numa_nodes()[node].empty())
+            MIGRAPHX_THROW("Invalid numa node: " + std::to_string(node));
+    }
+    return result;
+}
+
+static cpu_set_t make_cpu_set(const std::vector<std::size_t>& nodes)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto node : nodes)
+    {
+        for(auto c : get_numa_nodes().at(node))
+            CPU_SET(c, &set);
+    }
+    return set;
+}
+
+void pin_workers_to_numa_nodes(const std::vector<std::size_t>& nodes)
+{
+    static std::mutex m;
+    static std::vector<std::size_t> pinned;
+    std::lock_guard<std::mutex> lock(m);
+    if(nodes.empty() or nodes == pinned)
+        return;
+    auto set = make_cpu_set(nodes);
+    for(auto handle : get_thread_pool().native_handles())
+        pthread_setaffinity_np(handle, sizeof(set), &set);
+#ifndef MIGRAPHX_DISABLE_OMP
+    // The calling thread is the master of the team, so only the other threads are pinned
+#pragma omp parallel
+    {
+        if(omp_get_thread_num() != 0)
+            sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+    pinned = nodes;
+}
+
+void run_on_numa_node(std::size_t node, const std::function<void()>& f)
+{
+    std::thread t{[&] {
+        auto set = make_cpu_set({node});
+        sched_setaffinity(0, sizeof(set), &set);
+        f();
+    }};
+    t.join();
+}
+
+argument allocate_first_touch(const shape& s, std::size_t nthreads)
+{
+    // Large allocations are mapped without touching the pages
+    std::shared_ptr<char> buffer(static_cast<char*>(std::malloc(s.bytes())), &std::free);
+    if(buffer == nullptr and s.bytes() > 0)
+        MIGRAPHX_THROW("Failed to allocate " + std::to_string(s.bytes()) + " bytes");
+    const std::size_t page = 4096;
+    parallel_for(s.bytes(), page, nthreads, [&](std::size_t start, std::size_t last) {
+        std::fill(buffer.get() + start, buffer.get() + last, 0);
+    });
+    return {s, buffer};
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
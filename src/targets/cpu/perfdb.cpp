@@ -0,0 +1,98 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/perfdb.hpp>
+#include <migraphx/cpu/cache_dir.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/stringutils.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_PERFDB)
+
+static fs::path get_perfdb_path()
+{
+    auto p = string_value_of(MIGRAPHX_CPU_PERFDB{});
+    if(not p.empty())
+        return p;
+    // The stored solutions choose the kernels, so they are kept where other users can't write
+    auto dir = get_cache_dir("cpu-tuning");
+    if(dir.empty())
+        return {};
+    return dir / "perf.db";
+}
+
+static std::string quote(const std::string& s) { return "'" + replace_string(s, "'", "''") + "'"; }
+
+static std::string
+where_problem(const std::string& name, const std::string& isa, const value& problem)
+{
+    return " where name = " + quote(name) + " and isa = " + quote(isa) +
+           " and problem = " + quote(to_json_string(problem));
+}
+
+perfdb::perfdb(fs::path p) : path(std::move(p))
+{
+    if(path.empty())
+        path = get_perfdb_path();
+    if(path.empty() or not fs::exists(path))
+        return;
+    db     = sqlite::read(path);
+    opened = true;
+}
+
+optional<value> perfdb::find(const std::string& name, const value& problem)
+{
+    if(not opened)
+        return nullopt;
+    auto results = db.execute("select solution from perf_db" +
+                              where_problem(name, get_dnnl_isa(), problem) + ";");
+    if(results.empty())
+        return nullopt;
+    return from_json_string(results.front().at("solution"));
+}
+
+void perfdb::store(const std::string& name, const value& problem, const value& solution)
+{
+    if(path.empty())
+        return;
+    if(not writable)
+    {
+        db = sqlite::write(path);
+        db.execute("create table if not exists perf_db (name text, isa text, problem text, "
+                   "solution text, primary key (name, isa, problem));");
+        opened   = true;
+        writable = true;
+    }
+    db.execute("insert or replace into perf_db values (" + quote(name) + ", " +
+               quote(get_dnnl_isa()) + ", " + quote(to_json_string(problem)) + ", " +
+               quote(to_json_string(solution)) + ");");
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
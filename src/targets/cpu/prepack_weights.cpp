@@ -0,0 +1,72 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/prepack_weights.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+void prepack_weights::apply(module& m) const
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(not contains(
+               {"dnnl::convolution", "dnnl::dot", "dnnl::quant_convolution", "dnnl::quant_dot"},
+               ins->name()))
+            continue;
+        auto v = ins->get_operator().to_value();
+        if(v.at("prepacked").to<bool>())
+            continue;
+        auto weights = ins->inputs().at(1);
+        if(not weights->can_eval())
+            continue;
+        v["prepacked"]     = true;
+        v["weights_shape"] = to_value(weights->get_shape());
+        auto op            = make_op(ins->name(), v);
+        auto info          = compile(op, *ctx, ins->get_shape(), to_shapes(ins->inputs()));
+        auto src_desc      = from_binary(info.at("weights_desc").get_binary());
+        auto dst_desc      = from_binary(info.at("prepacked_desc").get_binary());
+        // Nothing to do when the primitive already prefers the layout of the weights
+        if(src_desc == dst_desc)
+            continue;
+        auto packed = reorder_weights(weights->eval(), src_desc, dst_desc);
+        auto l      = m.add_literal(literal{packed.get_shape(), packed.data()});
+        auto inputs = ins->inputs();
+        inputs.at(1) = l;
+        // Record the layout so finalize can check it matches the primitive it creates
+        v["packed_desc"] = info.at("prepacked_desc");
+        v["packed_isa"]  = get_dnnl_isa();
+        m.replace_instruction(ins, make_op(ins->name(), v), inputs);
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -58,6 +58,14 @@ struct dnnl_reduction : dnnl_op<dnnl_reduction, dnnl::reduction>
         return r;
     }
 
+    op_cost cost(const shape& output, std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        inputs = this->trim_post_op_inputs(inputs);
+        return make_op_cost(inputs.front().elements(), output, inputs);
+    }
+
     dnnl::reduction::desc get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         return {to_dnnl_algo(algo),
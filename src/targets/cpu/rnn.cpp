@@ -0,0 +1,284 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/op/common.hpp>
+#include <functional>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Runs a whole rnn, gru or lstm sequence with the dnnl rnn primitives. The inputs are x of
+ * [seq_len, batch, input], the weights of [directions, input, gates, hidden] and the recurrent
+ * weights of [directions, hidden, gates, hidden] in the ldigo layout, the bias of [directions,
+ * gates, hidden], the initial hidden state of [directions, batch, hidden] and, for lstm, the
+ * initial cell state. The output is the hidden states of [seq_len, directions, batch, hidden].
+ *
+ * lower_rnn inserts the op before the allocations exist, so lowering appends the allocation of
+ * the output as the last input like the other dnnl ops. Each direction runs as its own primitive
+ * that writes its slice of the output directly.
+ */
+struct dnnl_rnn : auto_register_op<dnnl_rnn>
+{
+    // One of lstm, gru, lbr_gru or rnn
+    std::string kind            = "lstm";
+    std::string activation      = "eltwise_tanh";
+    op::rnn_direction direction = op::rnn_direction::forward;
+    std::function<void(const std::vector<argument>& args, const argument& result)> execute;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.kind, "kind"),
+                    f(self.activation, "activation"),
+                    f(self.direction, "direction"));
+    }
+
+    std::string name() const { return "dnnl::rnn"; }
+
+    std::size_t gates() const
+    {
+        if(kind == "lstm")
+            return 4;
+        if(kind == "gru" or kind == "lbr_gru")
+            return 3;
+        return 1;
+    }
+
+    // The linear before reset gru has an extra bias for the last gate
+    std::size_t bias_gates() const { return kind == "lbr_gru" ? gates() + 1 : gates(); }
+
+    std::size_t states() const { return kind == "lstm" ? 2 : 1; }
+
+    bool has_allocation(const std::vector<shape>& inputs) const
+    {
+        return inputs.size() == 5 + states();
+    }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(4 + states(), 5 + states()).same_type().standard();
+        shape alloc{};
+        if(has_allocation(inputs))
+        {
+            alloc = inputs.back();
+            inputs.pop_back();
+        }
+        if(inputs[0].type() != shape::float_type)
+            MIGRAPHX_THROW(name() + ": Only float is supported");
+        if(inputs[0].ndim() != 3 or inputs[1].ndim() != 4 or inputs[3].ndim() != 3)
+            MIGRAPHX_THROW(name() + ": Invalid rank for inputs");
+        auto seq_len    = inputs[0].lens()[0];
+        auto batch      = inputs[0].lens()[1];
+        auto directions = inputs[1].lens()[0];
+        auto hidden     = inputs[1].lens()[3];
+        if(inputs[1].lens()[2] != gates() or inputs[3].lens()[1] != bias_gates())
+            MIGRAPHX_THROW(name() + ": Invalid number of gates for " + kind);
+        if(directions != (direction == op::rnn_direction::bidirectional ? 2 : 1))
+            MIGRAPHX_THROW(name() + ": Invalid number of directions");
+        for(std::size_t i = 0; i < states(); i++)
+        {
+            if(inputs[4 + i].lens() != std::vector<std::size_t>{directions, batch, hidden})
+                MIGRAPHX_THROW(name() + ": Invalid shape for initial state");
+        }
+        shape result{inputs[0].type(), {seq_len, directions, batch, hidden}};
+        if(not alloc.lens().empty() and alloc != result)
+            MIGRAPHX_THROW(name() + ": Invalid shape for the allocation");
+        return result;
+    }
+
+    dnnl::primitive create_primitive(dnnl::rnn_direction dir,
+                                     const dnnl::memory::desc& src_layer,
+                                     const dnnl::memory::desc& src_iter,
+                                     const dnnl::memory::desc& weights_layer,
+                                     const dnnl::memory::desc& weights_iter,
+                                     const dnnl::memory::desc& bias,
+                                     const dnnl::memory::desc& dst_layer) const
+    {
+        const auto& engine = get_dnnl_context().engine;
+        auto prop          = dnnl::prop_kind::forward_inference;
+        // The last states are not computed
+        dnnl::memory::desc none{};
+        if(kind == "lstm")
+        {
+            return dnnl::lstm_forward{dnnl::lstm_forward::primitive_desc{
+                dnnl::lstm_forward::desc{prop,
+                                         dir,
+                                         src_layer,
+                                         src_iter,
+                                         src_iter,
+                                         weights_layer,
+                                         weights_iter,
+                                         bias,
+                                         dst_layer,
+                                         none,
+                                         none},
+                engine}};
+        }
+        if(kind == "gru")
+        {
+            return dnnl::gru_forward{dnnl::gru_forward::primitive_desc{
+                dnnl::gru_forward::desc{prop,
+                                        dir,
+                                        src_layer,
+                                        src_iter,
+                                        weights_layer,
+                                        weights_iter,
+                                        bias,
+                                        dst_layer,
+                                        none},
+                engine}};
+        }
+        if(kind == "lbr_gru")
+        {
+            return dnnl::lbr_gru_forward{dnnl::lbr_gru_forward::primitive_desc{
+                dnnl::lbr_gru_forward::desc{prop,
+                                            dir,
+                                            src_layer,
+                                            src_iter,
+                                            weights_layer,
+                                            weights_iter,
+                                            bias,
+                                            dst_layer,
+                                            none},
+                engine}};
+        }
+        if(kind == "rnn")
+        {
+            return dnnl::vanilla_rnn_forward{dnnl::vanilla_rnn_forward::primitive_desc{
+                dnnl::vanilla_rnn_forward::desc{prop,
+                                                to_dnnl_algo(activation),
+                                                dir,
+                                                src_layer,
+                                                src_iter,
+                                                weights_layer,
+                                                weights_iter,
+                                                bias,
+                                                dst_layer,
+                                                none},
+                engine}};
+        }
+        MIGRAPHX_THROW(name() + ": Unknown rnn kind: " + kind);
+    }
+
+    // Identical layers share the primitives, so they are only created once in the process
+    dnnl::primitive get_primitive(bool reverse,
+                                  const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        auto v       = migraphx::to_value(*this);
+        v["reverse"] = reverse;
+        auto key     = dnnl_cache_key(name(), v, m);
+        auto dir     = reverse ? dnnl::rnn_direction::unidirectional_right2left
+                               : dnnl::rnn_direction::unidirectional_left2right;
+        return *std::static_pointer_cast<const dnnl::primitive>(dnnl_cache_lookup(key, [&] {
+            return std::make_shared<const dnnl::primitive>(
+                create_primitive(dir,
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_SRC_LAYER)),
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_SRC_ITER)),
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_LAYER)),
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_ITER)),
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_BIAS)),
+                                 m.at(MIGRAPHX_DNNL_PREFIX(ARG_DST_LAYER))));
+        }));
+    }
+
+    void finalize(context&, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        using dims = dnnl::memory::dims;
+        using tag  = dnnl::memory::format_tag;
+        auto dt    = to_dnnl_memory_data_type(output_shape.type());
+        auto lens  = output_shape.lens();
+        auto t     = static_cast<dnnl::memory::dim>(lens[0]);
+        auto d     = static_cast<dnnl::memory::dim>(lens[1]);
+        auto n     = static_cast<dnnl::memory::dim>(lens[2]);
+        auto h     = static_cast<dnnl::memory::dim>(lens[3]);
+        auto c     = static_cast<dnnl::memory::dim>(inputs[0].lens()[2]);
+        auto g     = static_cast<dnnl::memory::dim>(gates());
+        auto gb    = static_cast<dnnl::memory::dim>(bias_gates());
+        dnnl::memory::desc src_layer{dims{t, n, c}, dt, tag::tnc};
+        dnnl::memory::desc src_iter{dims{1, 1, n, h}, dt, tag::ldnc};
+        dnnl::memory::desc weights_layer{dims{1, 1, c, g, h}, dt, tag::ldigo};
+        dnnl::memory::desc weights_iter{dims{1, 1, h, g, h}, dt, tag::ldigo};
+        dnnl::memory::desc bias{dims{1, 1, gb, h}, dt, tag::ldgo};
+        // The directions are interleaved in the output, so each primitive writes with a stride
+        dnnl::memory::desc dst_layer{dims{t, n, h}, dt, dims{d * n * h, h, 1}};
+
+        std::unordered_map<int, dnnl::memory::desc> md = {
+            {MIGRAPHX_DNNL_PREFIX(ARG_SRC_LAYER), src_layer},
+            {MIGRAPHX_DNNL_PREFIX(ARG_SRC_ITER), src_iter},
+            {MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_LAYER), weights_layer},
+            {MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_ITER), weights_iter},
+            {MIGRAPHX_DNNL_PREFIX(ARG_BIAS), bias},
+            {MIGRAPHX_DNNL_PREFIX(ARG_DST_LAYER), dst_layer}};
+        std::vector<dnnl::primitive> prims;
+        for(dnnl::memory::dim i = 0; i < d; i++)
+            prims.push_back(get_primitive(direction == op::rnn_direction::reverse or i == 1, md));
+        bool is_lstm = kind == "lstm";
+        execute      = [=](const std::vector<argument>& args, const argument& result) {
+            const auto& engine = get_dnnl_context().engine;
+            // Memory for the slice of direction i, where each direction has the given size
+            auto slice = [&](const dnnl::memory::desc& md, const argument& a, auto i, auto size) {
+                return dnnl::memory{md, engine, a.data() + i * size * sizeof(float)};
+            };
+            for(dnnl::memory::dim i = 0; i < d; i++)
+            {
+                std::unordered_map<int, dnnl::memory> m;
+                m[MIGRAPHX_DNNL_PREFIX(ARG_SRC_LAYER)] = to_dnnl_memory(src_layer, args[0]);
+                m[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_LAYER)] =
+                    slice(weights_layer, args[1], i, c * g * h);
+                m[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS_ITER)] =
+                    slice(weights_iter, args[2], i, h * g * h);
+                m[MIGRAPHX_DNNL_PREFIX(ARG_BIAS)]      = slice(bias, args[3], i, gb * h);
+                m[MIGRAPHX_DNNL_PREFIX(ARG_SRC_ITER)]  = slice(src_iter, args[4], i, n * h);
+                m[MIGRAPHX_DNNL_PREFIX(ARG_DST_LAYER)] = slice(dst_layer, result, i, n * h);
+                if(is_lstm)
+                    m[MIGRAPHX_DNNL_PREFIX(ARG_SRC_ITER_C)] = slice(src_iter, args[5], i, n * h);
+                prims[i].execute(get_dnnl_stream(), m);
+            }
+        };
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        auto threads = limit_dnnl_threads(ctx);
+        if(args.size() != 5 + states())
+            MIGRAPHX_THROW(name() + ": Missing allocation for the output of " + kind);
+        execute(args, args.back());
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        if(not has_allocation(shapes))
+            return -1;
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
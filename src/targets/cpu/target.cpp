@@ -36,6 +36,8 @@
 #include <migraphx/layout_nhwc.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/register_op.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/replace_allocate.hpp>
 #include <migraphx/rewrite_pooling.hpp>
@@ -45,12 +47,18 @@
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
+#include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/lower_rnn.hpp>
+#include <migraphx/cpu/prepack_weights.hpp>
+#include <migraphx/cpu/tune_ops.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
 #include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
@@ -61,22 +69,121 @@ namespace cpu {
 
 std::string target::name() const { return "cpu"; }
 
+// Operators that only move data or control flow, so they can keep any type
+static std::set<std::string> data_ops()
+{
+    return {"broadcast",
+            "contiguous",
+            "convert",
+            "flatten",
+            "gather",
+            "get_tuple_elem",
+            "if",
+            "loop",
+            "multibroadcast",
+            "reshape",
+            "select_module",
+            "slice",
+            "squeeze",
+            "transpose",
+            "unsqueeze"};
+}
+
+// All the operators except the ones that have a kernel for the type
+static std::set<std::string> unsupported_ops_except(const std::set<std::string>& ops)
+{
+    auto supported = data_ops();
+    supported.insert(ops.begin(), ops.end());
+    std::set<std::string> result;
+    for(const auto& name : get_operators())
+    {
+        if(not contains(supported, name))
+            result.insert(name);
+    }
+    return result;
+}
+
+// Either "native", "storage" or "float". In "storage" mode fp16 is only used for the data, so it
+// is converted to float around every operator that computes.
+static std::string get_fp16_mode(const compile_options& options)
+{
+    if(options.fp16_mode == "native")
+        return has_native_f16() ? "native" : "float";
+    if(options.fp16_mode == "storage" or options.fp16_mode == "float")
+        return options.fp16_mode;
+    MIGRAPHX_THROW("Unknown fp16 mode: " + options.fp16_mode);
+}
+
+// The operators that have a dnnl kernel for fp16
+static std::set<std::string> half_ops(const std::string& mode)
+{
+    if(mode != "native")
+        return {};
+    return {"abs",
+            "add",
+            "convolution",
+            "div",
+            "dot",
+            "elu",
+            "exp",
+            "log",
+            "logsoftmax",
+            "max",
+            "min",
+            "mul",
+            "pow",
+            "reduce_max",
+            "reduce_mean",
+            "reduce_min",
+            "reduce_sum",
+            "relu",
+            "rsqrt",
+            "softmax",
+            "sqrt",
+            "sub",
+            "tanh"};
+}
+
 // cppcheck-suppress constParameterReference
-std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options&) const
+std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options& options) const
 {
     auto& ctx = any_cast<context>(gctx);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
     unsupported_types.erase(shape::type_t::float_type);
+    // The int8 operators are lowered to dnnl, and the other operators are kept in int8 when they
+    // only move data, so the quantized values are not converted back and forth
+    std::set<shape::type_t> int8_types = {
+        shape::type_t::int8_type, shape::type_t::uint8_type, shape::type_t::int32_type};
+    for(auto t : int8_types)
+        unsupported_types.erase(t);
+    auto fp16_mode                     = get_fp16_mode(options);
+    std::set<shape::type_t> half_types = {};
+    if(fp16_mode != "float")
+    {
+        half_types.insert(shape::type_t::half_type);
+        unsupported_types.erase(shape::type_t::half_type);
+    }
+    // Keep the fp16 weights from being folded into float literals when only the storage is fp16
+    std::unordered_set<std::string> skip_const_ops = {};
+    if(fp16_mode == "storage")
+        skip_const_ops.insert("convert");
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
             eliminate_data_type{unsupported_types, shape::type_t::float_type},
+            eliminate_data_type{int8_types,
+                                shape::type_t::float_type,
+                                unsupported_ops_except({"quant_dot", "quant_convolution"})},
+            eliminate_data_type{
+                half_types, shape::type_t::float_type, unsupported_ops_except(half_ops(fp16_mode))},
             dead_code_elimination{},
             simplify_reshapes{},
             eliminate_convert{},
             eliminate_identity{},
             eliminate_pad{},
             dead_code_elimination{},
+            lower_rnn{},
+            dead_code_elimination{},
             rewrite_rnn{},
             dead_code_elimination{},
             eliminate_common_subexpression{},
@@ -93,7 +200,7 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             eliminate_convert{},
             dead_code_elimination{},
-            propagate_constant{},
+            propagate_constant{skip_const_ops},
             dead_code_elimination{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
@@ -104,14 +211,27 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
+            tune_ops{&ctx, options.exhaustive_tune},
+            dead_code_elimination{},
+            prepack_weights{&ctx},
+            dead_code_elimination{},
             write_literals{},
             dead_code_elimination{},
+            schedule{cpu::schedule_model{ctx.get_streams()}, ctx.get_streams() > 1},
             memory_coloring{"cpu::allocate"},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
             dead_code_elimination{}};
 }
 
+migraphx::context target::get_context() const
+{
+    context ctx;
+    // Copies of the context are made for each evaluation, so the threads are only pinned here
+    pin_workers_to_numa_nodes(ctx.get_numa_nodes());
+    return ctx;
+}
+
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
 
 MIGRAPHX_REGISTER_TARGET(target);
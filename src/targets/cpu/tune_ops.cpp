@@ -0,0 +1,135 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/tune_ops.hpp>
+#include <migraphx/cpu/perfdb.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/time.hpp>
+#include <iostream>
+#include <limits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_CPU_TUNING)
+
+static const std::unordered_map<std::string, std::vector<std::string>>& tuning_candidates()
+{
+    static const std::unordered_map<std::string, std::vector<std::string>> m = {
+        {"dnnl::convolution", {"convolution_auto", "convolution_direct", "convolution_winograd"}},
+        {"dnnl::quant_convolution", {"convolution_auto", "convolution_direct"}}};
+    return m;
+}
+
+static value get_problem(instruction_ref ins)
+{
+    auto v = ins->get_operator().to_value();
+    // The algorithm is the solution, so it is not part of the problem
+    v["algo"] = "";
+    return {{"op", v},
+            {"inputs", to_value(to_shapes(ins->inputs()))},
+            {"output", to_value(ins->get_shape())}};
+}
+
+static double
+benchmark(context& ctx, operation op, const shape& output, const std::vector<shape>& inputs)
+{
+    migraphx::context gctx = std::ref(ctx);
+    op.finalize(gctx, output, inputs);
+    std::vector<argument> args(inputs.size());
+    std::transform(inputs.begin(), inputs.end(), args.begin(), [](const auto& s) {
+        return generate_argument(s);
+    });
+    // Warm up, so the page faults of the first run are not timed
+    op.compute(gctx, output, args);
+    const std::size_t n = 10;
+    auto total          = time<std::chrono::duration<double, std::milli>>([&] {
+        for(std::size_t i = 0; i < n; i++)
+            op.compute(gctx, output, args);
+    });
+    return total / n;
+}
+
+static value tune(context& ctx, instruction_ref ins)
+{
+    auto v           = ins->get_operator().to_value();
+    std::string best = v.at("algo").to<std::string>();
+    double best_time = std::numeric_limits<double>::max();
+    for(const auto& algo : tuning_candidates().at(ins->name()))
+    {
+        v["algo"] = algo;
+        try
+        {
+            auto t = benchmark(
+                ctx, make_op(ins->name(), v), ins->get_shape(), to_shapes(ins->inputs()));
+            if(enabled(MIGRAPHX_TRACE_CPU_TUNING{}))
+                std::cout << ins->name() << " " << algo << ": " << t << "ms" << std::endl;
+            if(t < best_time)
+            {
+                best      = algo;
+                best_time = t;
+            }
+        }
+        // The algorithm is not available for this problem
+        catch(const std::exception& e)
+        {
+            if(enabled(MIGRAPHX_TRACE_CPU_TUNING{}))
+                std::cout << ins->name() << " " << algo << ": " << e.what() << std::endl;
+        }
+    }
+    return {{"algo", best}};
+}
+
+void tune_ops::apply(module& m) const
+{
+    perfdb db{perfdb_path};
+    for(auto ins : iterator_for(m))
+    {
+        if(not contains(tuning_candidates(), ins->name()))
+            continue;
+        auto problem  = get_problem(ins);
+        auto solution = db.find(ins->name(), problem);
+        if(not solution.has_value())
+        {
+            if(not exhaustive)
+                continue;
+            solution = tune(*ctx, ins);
+            db.store(ins->name(), problem, *solution);
+        }
+        auto v    = ins->get_operator().to_value();
+        v["algo"] = solution->at("algo");
+        m.replace_instruction(ins, make_op(ins->name(), v), ins->inputs());
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -22,6 +22,8 @@
  * THE SOFTWARE.
  */
 #include <migraphx/cpu/write_literals.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
@@ -34,6 +36,8 @@ namespace cpu {
 struct cpu_literal
 {
     argument data;
+    // Copies of the data on each numa node, indexed by the node
+    std::vector<argument> replicas;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
@@ -45,7 +49,28 @@ struct cpu_literal
 
     shape compute_shape(const std::vector<shape>&) const { return data.get_shape(); }
 
-    argument compute(const shape&, const std::vector<argument>&) const { return data; }
+    void finalize(context& ctx, const shape&, const std::vector<shape>&)
+    {
+        replicas.clear();
+        if(not ctx.replicate_literals())
+            return;
+        for(auto node : ctx.get_numa_nodes())
+        {
+            if(node >= replicas.size())
+                replicas.resize(node + 1);
+            run_on_numa_node(node, [&] { replicas[node] = data.copy(); });
+        }
+    }
+
+    argument compute(context&, const shape&, const std::vector<argument>&) const
+    {
+        if(replicas.empty())
+            return data;
+        auto node = get_current_numa_node();
+        if(node >= replicas.size() or replicas[node].empty())
+            return data;
+        return replicas[node];
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const cpu_literal& x)
     {
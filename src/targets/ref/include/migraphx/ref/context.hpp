@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/arena.hpp>
 #include <migraphx/ref/export.h>
 
 namespace migraphx {
@@ -33,7 +34,25 @@ namespace ref {
 
 struct context
 {
+    context() = default;
+    // The arena is not copied, so copies of the context can be used to evaluate the same program
+    // concurrently
+    context(const context&) {}
+    context& operator=(const context&) { return *this; }
+    ~context() = default;
+
     void finish() const {}
+
+    void reset_memory() const { memory.reset(); }
+
+    argument detach_memory(const argument& result) const { return memory.detach(result); }
+
+    /// Allocates the results of the operators
+    arena& get_arena() { return memory; }
+
+    private:
+    // The arena is synchronized, so it can be reset through a shared context
+    mutable arena memory;
 };
 
 } // namespace ref
@@ -83,8 +83,9 @@ struct ref_lrn
 
     std::string name() const { return "ref::lrn"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, shape output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, shape output_shape, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         argument result{output_shape};
         visit_all(result, args[0])([&](auto output, auto input) {
             int n_batch         = output_shape.lens()[0];
@@ -147,8 +148,9 @@ struct ref_im2col
         return op.normalize_compute_shape(inputs);
     }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         argument result{output_shape};
         auto input_shape   = args[0].get_shape();
         auto weights_shape = args[1].get_shape();
@@ -207,8 +209,14 @@ struct ref_op
     }
     std::string name() const { return "ref::op"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
     {
+        return op.cost(output, inputs);
+    }
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        arena_scope scope{ctx.get_arena()};
         return op.compute(output_shape, args);
     }
     value to_value() const
@@ -242,8 +250,9 @@ struct ref_pad
 
     std::string name() const { return "ref::pad"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         assert(dyn_out.computed_shape.standard());
         argument result{dyn_out.computed_shape};
         result.visit([&](auto output) {
@@ -278,9 +287,14 @@ struct ref_gemm
     }
     std::string name() const { return "ref::dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return op.cost(output, inputs);
+    }
 
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         argument result{dyn_out.computed_shape};
         visit_all(result, args[0], args[1])(
             [&](auto cmat, auto amat, auto bmat) { gemm(cmat, amat, bmat, 1.0f, 0.0f); });
@@ -301,9 +315,14 @@ struct ref_quant_gemm
 
     std::string name() const { return "ref::quant_dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return op.cost(output, inputs);
+    }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         argument result{output_shape};
         result.visit([&](auto cmat) {
             visit_all(args.at(0), args.at(1))(
@@ -335,8 +354,13 @@ struct ref_softmax : auto_register_op<ref_softmax<Op>>
     {
         return op.normalize_compute_shape(inputs);
     }
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    op_cost cost(const shape& output, const std::vector<shape>& inputs) const
+    {
+        return op.cost(output, inputs);
+    }
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        arena_scope scope{ctx.get_arena()};
         argument result{dyn_out.computed_shape};
         auto batch_lens        = dyn_out.computed_shape.lens();
         int64_t tuned_axis     = tune_axis(args[0].get_shape().lens().size(), op.axis, op.name());
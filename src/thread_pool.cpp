@@ -0,0 +1,288 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_THREAD_POOL)
+
+struct task_queue
+{
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+};
+
+struct thread_pool_impl;
+
+// The pool and worker index of the calling thread
+static thread_local const thread_pool_impl* current_pool = nullptr; // NOLINT
+static thread_local std::size_t current_worker           = 0;       // NOLINT
+
+struct thread_pool_impl
+{
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next{0};
+    bool stop = false;
+    std::atomic<std::size_t> tasks{0};
+    std::atomic<std::size_t> steals{0};
+    std::atomic<std::int64_t> idle_ns{0};
+
+    explicit thread_pool_impl(std::size_t n)
+    {
+        queues.reserve(n);
+        std::generate_n(
+            std::back_inserter(queues), n, [] { return std::make_unique<task_queue>(); });
+        threads.reserve(n);
+        for(auto i : range(n))
+            threads.emplace_back([this, i] { this->run(i); });
+    }
+
+    ~thread_pool_impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        for(auto& t : threads)
+            t.join();
+    }
+
+    void push(std::function<void()> f)
+    {
+        auto i = current_pool == this ? current_worker : next++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[i]->mutex);
+            queues[i]->tasks.push_back(std::move(f));
+        }
+        {
+            // Take the lock so a worker that is about to sleep doesn't miss the notification
+            std::lock_guard<std::mutex> lock(mutex);
+            pending++;
+        }
+        tasks++;
+        cv.notify_one();
+    }
+
+    bool pop(std::size_t i, std::function<void()>& f)
+    {
+        // Newest task of the worker's own queue first
+        {
+            auto& q = *queues[i];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if(not q.tasks.empty())
+            {
+                f = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                pending--;
+                return true;
+            }
+        }
+        // Steal the oldest task from the other workers
+        for(std::size_t k = 1; k < queues.size(); k++)
+        {
+            auto& q = *queues[(i + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if(not q.tasks.empty())
+            {
+                f = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                pending--;
+                steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(std::size_t i)
+    {
+        current_pool   = this;
+        current_worker = i;
+        for(;;)
+        {
+            std::function<void()> f;
+            if(pop(i, f))
+            {
+                f();
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return stop or pending > 0; });
+            idle_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+            if(stop and pending == 0)
+                return;
+        }
+    }
+};
+
+thread_pool::thread_pool(std::size_t n)
+    : impl(std::make_unique<thread_pool_impl>(std::max<std::size_t>(n, 1)))
+{
+}
+
+thread_pool::~thread_pool() = default;
+
+void thread_pool::submit(std::function<void()> f) { impl->push(std::move(f)); }
+
+std::size_t thread_pool::size() const { return impl->threads.size(); }
+
+bool thread_pool::is_worker() const { return current_pool == impl.get(); }
+
+std::vector<std::thread::native_handle_type> thread_pool::native_handles() const
+{
+    std::vector<std::thread::native_handle_type> result;
+    std::transform(impl->threads.begin(),
+                   impl->threads.end(),
+                   std::back_inserter(result),
+                   [](std::thread& t) { return t.native_handle(); });
+    return result;
+}
+
+struct chunk_state
+{
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> next_tid{1};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t finished = 0;
+    std::exception_ptr error;
+};
+
+void thread_pool::run_chunks(std::size_t nchunks,
+                             std::size_t nthreads,
+                             const std::function<void(std::size_t, std::size_t)>& f)
+{
+    // The state is shared with helpers that may only start after all the chunks are finished
+    auto state = std::make_shared<chunk_state>();
+    auto work  = [state, &f, nchunks](std::size_t tid) {
+        std::size_t done = 0;
+        std::exception_ptr error;
+        for(auto i = state->next++; i < nchunks; i = state->next++)
+        {
+            // Skip the remaining chunks after an exception, but still count them as finished
+            if(not state->failed)
+            {
+                try
+                {
+                    f(i, tid);
+                }
+                catch(...)
+                {
+                    error         = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            done++;
+        }
+        if(done == 0)
+            return;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if(error != nullptr and state->error == nullptr)
+            state->error = error;
+        state->finished += done;
+        if(state->finished == nchunks)
+            state->cv.notify_all();
+    };
+    auto helpers = std::min({nthreads - 1, this->size(), nchunks - 1});
+    for(std::size_t i = 0; i < helpers; i++)
+        this->submit([state, work] { work(state->next_tid++); });
+    work(0);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->finished == nchunks; });
+    if(state->error != nullptr)
+        std::rethrow_exception(state->error);
+}
+
+thread_pool_stats thread_pool::get_stats() const
+{
+    thread_pool_stats result;
+    result.tasks   = impl->tasks;
+    result.steals  = impl->steals;
+    result.idle_ms = impl->idle_ns / 1.0e6;
+    return result;
+}
+
+void thread_pool::reset_stats()
+{
+    impl->tasks   = 0;
+    impl->steals  = 0;
+    impl->idle_ns = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const thread_pool_stats& s)
+{
+    os << "Tasks: " << s.tasks << ", Steals: " << s.steals << ", Idle: " << s.idle_ms << "ms";
+    return os;
+}
+
+namespace {
+struct global_thread_pool : thread_pool
+{
+    using thread_pool::thread_pool;
+    global_thread_pool(const global_thread_pool&)            = delete;
+    global_thread_pool& operator=(const global_thread_pool&) = delete;
+    ~global_thread_pool()
+    {
+        if(enabled(MIGRAPHX_TRACE_THREAD_POOL{}))
+            std::cout << "Thread pool: " << this->get_stats() << std::endl;
+    }
+};
+} // namespace
+
+thread_pool& get_thread_pool()
+{
+    // The calling thread takes part in parallel loops, so it is not counted in the workers
+    static global_thread_pool pool{
+        std::max<std::size_t>(value_of(MIGRAPHX_NUM_THREADS{}, std::thread::hardware_concurrency()),
+                              1) -
+        1};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,223 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/timeline.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/value.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct timeline_impl
+{
+    timeline::clock::time_point origin = timeline::clock::now();
+    mutable std::mutex mutex;
+    std::vector<timeline_event> events;
+    std::unordered_map<std::thread::id, std::size_t> threads;
+    const program* prog = nullptr;
+    // The operator and the name of each instruction
+    std::unordered_map<instruction_ref, std::pair<std::string, std::string>> names;
+
+    double to_us(timeline::clock::time_point t) const
+    {
+        return std::chrono::duration<double, std::micro>(t - origin).count();
+    }
+
+    // Must be called with the lock held
+    std::size_t get_tid()
+    {
+        return threads.emplace(std::this_thread::get_id(), threads.size()).first->second;
+    }
+};
+
+timeline::timeline() : impl(std::make_unique<timeline_impl>()) {}
+
+timeline::~timeline() = default;
+
+void timeline::start(const program& p)
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if(impl->prog == &p)
+        return;
+    impl->prog = &p;
+    impl->names.clear();
+    // Use the same names as when the program is printed
+    for(const auto* mod : p.get_modules())
+    {
+        std::string prefix;
+        if(not mod->name().empty() and mod->name() != "main")
+            prefix = mod->name() + ":";
+        std::size_t i = 0;
+        for(auto ins : iterator_for(*mod))
+        {
+            // Wrapped operators share a name, so use how the operator prints without attributes
+            auto op = to_string(ins->get_operator());
+            op      = op.substr(0, op.find('['));
+            if(ins->name() == "@param")
+                impl->names[ins] = {
+                    op, prefix + any_cast<builtin::param>(ins->get_operator()).parameter};
+            else
+                impl->names[ins] = {op, prefix + "@" + std::to_string(i)};
+            i++;
+        }
+    }
+}
+
+void timeline::record(instruction_ref ins,
+                      const argument& result,
+                      clock::time_point start,
+                      clock::time_point stop)
+{
+    timeline_event e;
+    e.name        = ins->name();
+    e.start_us    = impl->to_us(start);
+    e.duration_us = impl->to_us(stop) - e.start_us;
+    e.output      = result.get_shape();
+    e.bytes       = e.output.dynamic() ? 0 : e.output.bytes();
+    for(auto input : ins->inputs())
+    {
+        const auto& s = input->get_shape();
+        e.inputs.push_back(s);
+        if(not s.dynamic())
+            e.bytes += s.bytes();
+    }
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    e.tid   = impl->get_tid();
+    auto it = impl->names.find(ins);
+    if(it != impl->names.end())
+    {
+        e.name        = it->second.first;
+        e.instruction = it->second.second;
+    }
+    impl->events.push_back(std::move(e));
+}
+
+void timeline::record_eval(clock::time_point start, clock::time_point stop)
+{
+    timeline_event e;
+    e.name        = "eval";
+    e.start_us    = impl->to_us(start);
+    e.duration_us = impl->to_us(stop) - e.start_us;
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    e.tid = impl->get_tid();
+    impl->events.push_back(std::move(e));
+}
+
+std::vector<timeline_event> timeline::get_events() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->events;
+}
+
+void timeline::clear()
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    impl->events.clear();
+}
+
+static value to_chrome_event(const timeline_event& e)
+{
+    value args = value::object{};
+    if(not e.instruction.empty())
+        args["instruction"] = e.instruction;
+    if(e.name != "eval")
+    {
+        std::vector<std::string> inputs;
+        std::transform(e.inputs.begin(),
+                       e.inputs.end(),
+                       std::back_inserter(inputs),
+                       [](const shape& s) { return to_string(s); });
+        args["inputs"] = inputs;
+        args["output"] = to_string(e.output);
+        args["bytes"]  = e.bytes;
+    }
+    value result   = value::object{};
+    result["name"] = e.name;
+    result["cat"]  = e.name == "eval" ? "eval" : "instruction";
+    result["ph"]   = "X";
+    result["ts"]   = e.start_us;
+    result["dur"]  = e.duration_us;
+    result["pid"]  = 0;
+    result["tid"]  = e.tid;
+    result["args"] = args;
+    return result;
+}
+
+void timeline::write_chrome_trace(std::ostream& os) const
+{
+    value events         = value::array{};
+    std::size_t nthreads = 0;
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        nthreads = impl->threads.size();
+        for(const auto& e : impl->events)
+            events.push_back(to_chrome_event(e));
+    }
+    for(std::size_t tid = 0; tid < nthreads; tid++)
+    {
+        value name   = value::object{};
+        name["name"] = "thread_name";
+        name["ph"]   = "M";
+        name["pid"]  = 0;
+        name["tid"]  = tid;
+        name["args"] = {{"name", "Thread " + std::to_string(tid)}};
+        events.push_back(name);
+    }
+    value trace              = value::object{};
+    trace["traceEvents"]     = events;
+    trace["displayTimeUnit"] = "ms";
+    os << to_json_string(trace);
+}
+
+void timeline::write_chrome_trace(const std::string& filename) const
+{
+    std::ofstream os(filename);
+    if(not os)
+        MIGRAPHX_THROW("Failed to open trace file: " + filename);
+    this->write_chrome_trace(os);
+}
+
+std::string timeline::to_chrome_trace() const
+{
+    std::stringstream ss;
+    this->write_chrome_trace(ss);
+    return ss.str();
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -23,6 +23,10 @@
  */
 #include <migraphx/migraphx.h>
 #include <migraphx/migraphx.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include "test.hpp"
 
 TEST_CASE(load_and_run)
@@ -45,6 +49,66 @@ TEST_CASE(load_and_run)
     CHECK(bool{shapes_before.front() == outputs.front().get_shape()});
 }
 
+TEST_CASE(load_and_run_execution_state)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    migraphx::execution_state state1{p};
+    migraphx::execution_state state2{p};
+    auto outputs1 = state1.eval(pp);
+    auto outputs2 = state2.eval(pp);
+    auto outputs  = p.eval(pp);
+    CHECK(bool{outputs1.front() == outputs.front()});
+    CHECK(bool{outputs2.front() == outputs.front()});
+}
+
+TEST_CASE(load_and_run_bind_output)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    auto output_shape = p.get_output_shapes()[0];
+    std::vector<char> buffer(output_shape.bytes());
+    migraphx::argument output{output_shape, buffer.data()};
+    migraphx::execution_state state{p};
+    state.bind_output(0, output);
+    auto outputs = state.eval(pp);
+    CHECK(bool{outputs.front().data() == buffer.data()});
+    CHECK(bool{outputs.front() == p.eval(pp).front()});
+    CHECK(test::throws([&] { state.bind_output(1, output); }));
+    CHECK(test::throws([&] { state.bind_output("output", output); }));
+}
+
+TEST_CASE(load_and_run_trace)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    std::string trace_file = "load_and_run_trace.json";
+    auto outputs           = p.eval_with_trace(pp, trace_file.c_str());
+    CHECK(bool{outputs.front() == p.eval(pp).front()});
+    std::ifstream is(trace_file);
+    std::string trace{std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{}};
+    CHECK(trace.find("traceEvents") != std::string::npos);
+    std::remove(trace_file.c_str());
+}
+
 TEST_CASE(load_and_run_init_list)
 {
     auto p             = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
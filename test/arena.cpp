@@ -0,0 +1,197 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/arena.hpp>
+#include <migraphx/argument.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+
+static bool is_aligned(const char* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % migraphx::arena::alignment == 0;
+}
+
+TEST_CASE(alignment)
+{
+    migraphx::arena a;
+    std::vector<std::shared_ptr<char>> buffers;
+    for(std::size_t n : {1, 3, 64, 65, 1000})
+        buffers.push_back(a.allocate(n));
+    EXPECT(std::all_of(
+        buffers.begin(), buffers.end(), [](const auto& b) { return is_aligned(b.get()); }));
+    EXPECT(a.get_stats().allocations == buffers.size());
+}
+
+TEST_CASE(reuse_after_reset)
+{
+    migraphx::arena a;
+    auto run = [&] {
+        a.reset();
+        auto x = a.allocate(128);
+        auto y = a.allocate(256);
+        return std::vector<std::uintptr_t>{reinterpret_cast<std::uintptr_t>(x.get()),
+                                           reinterpret_cast<std::uintptr_t>(y.get())};
+    };
+    // The first evaluation finds the size of the block to use
+    run();
+    auto first  = run();
+    auto blocks = a.get_stats().blocks;
+    EXPECT(first[1] - first[0] == 128);
+    for(int i = 0; i < 4; i++)
+        EXPECT(run() == first);
+    auto stats = a.get_stats();
+    EXPECT(stats.blocks == blocks);
+    EXPECT(stats.high_water == 384);
+    EXPECT(stats.capacity == 384);
+    EXPECT(stats.allocations == 12);
+}
+
+TEST_CASE(live_results_are_kept)
+{
+    migraphx::arena a;
+    a.reset();
+    auto x = a.allocate(64);
+    std::fill_n(x.get(), 64, 1);
+    a.reset();
+    auto y = a.allocate(64);
+    std::fill_n(y.get(), 64, 2);
+    EXPECT(static_cast<void*>(x.get()) != static_cast<void*>(y.get()));
+    EXPECT(std::all_of(x.get(), x.get() + 64, [](char c) { return c == 1; }));
+    // Once released, the block of x can be used again
+    x.reset();
+    a.reset();
+    auto z = a.allocate(64);
+    EXPECT(static_cast<void*>(z.get()) != static_cast<void*>(y.get()));
+    EXPECT(a.get_stats().blocks == 2);
+}
+
+TEST_CASE(grow_to_one_block)
+{
+    migraphx::arena a;
+    auto run = [&] {
+        a.reset();
+        std::vector<std::shared_ptr<char>> buffers;
+        for(std::size_t i = 1; i < 64; i++)
+            buffers.push_back(a.allocate(i * 64));
+    };
+    run();
+    EXPECT(a.get_stats().blocks > 1);
+    run();
+    auto blocks = a.get_stats().blocks;
+    run();
+    run();
+    auto stats = a.get_stats();
+    EXPECT(stats.blocks == blocks);
+    // Only one block is left
+    EXPECT(stats.capacity >= stats.high_water);
+    EXPECT(stats.capacity < 2 * stats.high_water);
+}
+
+TEST_CASE(scope)
+{
+    migraphx::arena a;
+    migraphx::shape s{migraphx::shape::float_type, {3, 5}};
+    {
+        migraphx::arena_scope scope{a};
+        EXPECT(migraphx::arena::current() == &a);
+        migraphx::argument x{s};
+        EXPECT(is_aligned(x.data()));
+        std::fill_n(x.data(), s.bytes(), 1);
+        x = migraphx::argument{};
+        // The memory of an argument is zero initialized
+        a.reset();
+        migraphx::argument y{s};
+        EXPECT(std::all_of(y.data(), y.data() + s.bytes(), [](char c) { return c == 0; }));
+    }
+    EXPECT(migraphx::arena::current() == nullptr);
+    migraphx::argument z{s};
+    EXPECT(a.get_stats().allocations == 2);
+}
+
+TEST_CASE(detach)
+{
+    migraphx::arena a;
+    migraphx::shape s{migraphx::shape::float_type, {3, 5}};
+    a.reset();
+    auto x = a.allocate(s);
+    std::fill_n(x.data(), s.bytes(), 1);
+    auto y = a.detach(x);
+    EXPECT(y.data() != x.data());
+    EXPECT(y == x);
+    // Arguments that are not from the arena are not copied
+    migraphx::argument z{s};
+    EXPECT(a.detach(z).data() == z.data());
+    auto t = a.detach(migraphx::argument{{x, z}}).get_sub_objects();
+    EXPECT(t.at(0).data() != x.data());
+    EXPECT(t.at(0) == x);
+    EXPECT(t.at(1).data() == z.data());
+}
+
+TEST_CASE(detached_results_release_blocks)
+{
+    migraphx::arena a;
+    std::vector<migraphx::argument> kept;
+    auto run = [&] {
+        a.reset();
+        auto x = a.allocate(migraphx::shape{migraphx::shape::float_type, {1024}});
+        auto y = a.allocate(migraphx::shape{migraphx::shape::float_type, {1}});
+        kept.push_back(a.detach(y));
+    };
+    run();
+    run();
+    auto blocks = a.get_stats().blocks;
+    for(int i = 0; i < 8; i++)
+        run();
+    EXPECT(a.get_stats().blocks == blocks);
+    EXPECT(kept.size() == 10);
+}
+
+TEST_CASE(concurrent_allocate)
+{
+    migraphx::arena a;
+    std::vector<std::vector<std::shared_ptr<char>>> buffers(4);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < buffers.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            for(int j = 0; j < 100; j++)
+            {
+                buffers[i].push_back(a.allocate(64));
+                std::fill_n(buffers[i].back().get(), 64, i);
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    for(std::size_t i = 0; i < buffers.size(); i++)
+    {
+        EXPECT(std::all_of(buffers[i].begin(), buffers[i].end(), [&](const auto& b) {
+            return std::all_of(b.get(), b.get() + 64, [&](char c) { return c == char(i); });
+        }));
+    }
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,255 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/convolution.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <test.hpp>
+
+using lens_t = std::vector<std::size_t>;
+
+// Gather each output element separately with the full index math
+template <class T, class U>
+static void naive_convolution(migraphx::tensor_view<T> output,
+                              migraphx::tensor_view<U> input,
+                              migraphx::tensor_view<U> weights,
+                              const lens_t& padding,
+                              const lens_t& stride,
+                              const lens_t& dilation,
+                              std::size_t group)
+{
+    const auto& os = output.get_shape();
+    const auto& ws = weights.get_shape();
+    auto in_lens   = input.get_shape().lens();
+    auto kg        = ws.lens()[0] / group;
+    migraphx::shape win{ws.type(), lens_t(ws.lens().begin() + 1, ws.lens().end())};
+    for(std::size_t i = 0; i < os.elements(); i++)
+    {
+        auto idx = os.multi(i);
+        auto g   = idx[1] / kg;
+        double s = 0.0;
+        for(std::size_t w = 0; w < win.elements(); w++)
+        {
+            auto widx = win.multi(w);
+            std::vector<std::ptrdiff_t> in_idx = {std::ptrdiff_t(idx[0]),
+                                                  std::ptrdiff_t(g * ws.lens()[1] + widx[0])};
+            bool inside = true;
+            for(std::size_t d = 0; d + 2 < idx.size(); d++)
+            {
+                auto x = std::ptrdiff_t(idx[d + 2] * stride[d] + widx[d + 1] * dilation[d]) -
+                         std::ptrdiff_t(padding[d]);
+                inside = inside and x >= 0 and x < std::ptrdiff_t(in_lens[d + 2]);
+                in_idx.push_back(x);
+            }
+            if(not inside)
+                continue;
+            lens_t wei_idx = {idx[1]};
+            wei_idx.insert(wei_idx.end(), widx.begin(), widx.end());
+            s += static_cast<double>(input(in_idx.begin(), in_idx.end())) *
+                 static_cast<double>(weights(wei_idx.begin(), wei_idx.end()));
+        }
+        output(idx.begin(), idx.end()) = static_cast<T>(s);
+    }
+}
+
+// Scatter each input element separately with the full index math
+template <class T>
+static void naive_convolution_backwards(migraphx::tensor_view<T> output,
+                                        migraphx::tensor_view<T> input,
+                                        migraphx::tensor_view<T> weights,
+                                        const lens_t& padding,
+                                        const lens_t& stride,
+                                        const lens_t& dilation)
+{
+    const auto& is = input.get_shape();
+    const auto& ws = weights.get_shape();
+    auto out_lens  = output.get_shape().lens();
+    std::vector<double> acc(output.get_shape().elements());
+    migraphx::shape out_std{ws.type(), out_lens};
+    migraphx::shape win{ws.type(), lens_t(ws.lens().begin() + 1, ws.lens().end())};
+    for(std::size_t i = 0; i < is.elements(); i++)
+    {
+        auto idx = is.multi(i);
+        for(std::size_t w = 0; w < win.elements(); w++)
+        {
+            auto widx      = win.multi(w);
+            lens_t out_idx = {idx[0], widx[0]};
+            bool inside    = true;
+            for(std::size_t d = 0; d + 2 < idx.size(); d++)
+            {
+                auto x = std::ptrdiff_t(idx[d + 2] * stride[d] + widx[d + 1] * dilation[d]) -
+                         std::ptrdiff_t(padding[d]);
+                inside = inside and x >= 0 and x < std::ptrdiff_t(out_lens[d + 2]);
+                out_idx.push_back(x);
+            }
+            if(not inside)
+                continue;
+            lens_t wei_idx = {idx[1]};
+            wei_idx.insert(wei_idx.end(), widx.begin(), widx.end());
+            acc[out_std.index(out_idx)] +=
+                static_cast<double>(input(idx.begin(), idx.end())) *
+                static_cast<double>(weights(wei_idx.begin(), wei_idx.end()));
+        }
+    }
+    for(std::size_t i = 0; i < acc.size(); i++)
+    {
+        auto idx                         = out_std.multi(i);
+        output(idx.begin(), idx.end()) = static_cast<T>(acc[i]);
+    }
+}
+
+template <class T>
+static bool all_close(const std::vector<T>& expected, const std::vector<T>& result, double tolerance)
+{
+    return std::equal(expected.begin(), expected.end(), result.begin(), [&](auto x, auto y) {
+        auto dx = static_cast<double>(x);
+        auto dy = static_cast<double>(y);
+        return std::abs(dx - dy) <= tolerance * std::max(1.0, std::abs(dx));
+    });
+}
+
+template <class T, class U>
+static bool check_convolution(const migraphx::shape& out_shape,
+                              const migraphx::shape& in_shape,
+                              const migraphx::shape& wei_shape,
+                              const lens_t& padding,
+                              const lens_t& stride,
+                              const lens_t& dilation,
+                              std::size_t group,
+                              double tolerance = 1e-4)
+{
+    auto x = migraphx::generate_argument(in_shape, 1);
+    auto w = migraphx::generate_argument(wei_shape, 2);
+    std::vector<T> expected(out_shape.elements());
+    std::vector<T> result(out_shape.elements());
+    auto xv = migraphx::make_view(in_shape, reinterpret_cast<U*>(x.data()));
+    auto wv = migraphx::make_view(wei_shape, reinterpret_cast<U*>(w.data()));
+    naive_convolution(migraphx::make_view(out_shape, expected.data()),
+                      xv,
+                      wv,
+                      padding,
+                      stride,
+                      dilation,
+                      group);
+    migraphx::convolution(migraphx::make_view(out_shape, result.data()),
+                          xv,
+                          wv,
+                          padding,
+                          stride,
+                          dilation,
+                          group);
+    return all_close(expected, result, tolerance);
+}
+
+static bool check_convolution_backwards(const migraphx::shape& out_shape,
+                                        const migraphx::shape& in_shape,
+                                        const migraphx::shape& wei_shape,
+                                        const lens_t& padding,
+                                        const lens_t& stride,
+                                        const lens_t& dilation)
+{
+    auto x = migraphx::generate_argument(in_shape, 1);
+    auto w = migraphx::generate_argument(wei_shape, 2);
+    std::vector<float> expected(out_shape.elements());
+    std::vector<float> result(out_shape.elements());
+    auto xv = migraphx::make_view(in_shape, reinterpret_cast<float*>(x.data()));
+    auto wv = migraphx::make_view(wei_shape, reinterpret_cast<float*>(w.data()));
+    naive_convolution_backwards(
+        migraphx::make_view(out_shape, expected.data()), xv, wv, padding, stride, dilation);
+    migraphx::convolution_backwards(
+        migraphx::make_view(out_shape, result.data()), xv, wv, padding, stride, dilation, 1);
+    return all_close(expected, result, 1e-4);
+}
+
+TEST_CASE(convolution_im2col)
+{
+    // Padding, stride and dilation, with enough columns to be split into several chunks
+    migraphx::shape xs{migraphx::shape::float_type, {2, 6, 40, 37}};
+    migraphx::shape ws{migraphx::shape::float_type, {10, 3, 3, 2}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 10, 21, 37}};
+    EXPECT(check_convolution<float, float>(ys, xs, ws, {2, 1}, {2, 1}, {1, 2}, 2));
+}
+
+TEST_CASE(convolution_im2col_3d)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 3, 7, 6, 5}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 3, 2, 3, 2}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 4, 6, 6, 4}};
+    EXPECT(check_convolution<float, float>(ys, xs, ws, {0, 1, 0}, {1, 1, 1}, {1, 1, 1}, 1));
+}
+
+TEST_CASE(convolution_pointwise)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {2, 12, 9, 11}};
+    migraphx::shape ws{migraphx::shape::float_type, {9, 4, 1, 1}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 9, 9, 11}};
+    EXPECT(check_convolution<float, float>(ys, xs, ws, {0, 0}, {1, 1}, {1, 1}, 3));
+}
+
+TEST_CASE(convolution_depthwise)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {2, 5, 13, 14}};
+    migraphx::shape ws{migraphx::shape::float_type, {5, 1, 3, 3}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 5, 7, 7}};
+    EXPECT(check_convolution<float, float>(ys, xs, ws, {1, 1}, {2, 2}, {1, 1}, 5));
+}
+
+TEST_CASE(convolution_nonstandard)
+{
+    // Channels last input and output, and transposed weights
+    migraphx::shape xs{migraphx::shape::float_type, {2, 4, 8, 9}, {288, 1, 36, 4}};
+    migraphx::shape ws{migraphx::shape::float_type, {6, 4, 3, 3}, {1, 54, 18, 6}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 6, 8, 9}, {432, 1, 54, 6}};
+    EXPECT(check_convolution<float, float>(ys, xs, ws, {1, 1}, {1, 1}, {1, 1}, 1));
+}
+
+TEST_CASE(convolution_int8)
+{
+    migraphx::shape xs{migraphx::shape::int8_type, {1, 8, 10, 10}};
+    migraphx::shape ws{migraphx::shape::int8_type, {7, 8, 3, 3}};
+    migraphx::shape ys{migraphx::shape::int32_type, {1, 7, 8, 8}};
+    EXPECT(check_convolution<std::int32_t, std::int8_t>(ys, xs, ws, {0, 0}, {1, 1}, {1, 1}, 1, 0));
+}
+
+TEST_CASE(convolution_backwards_strided)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {2, 5, 6, 7}};
+    migraphx::shape ws{migraphx::shape::float_type, {5, 3, 3, 2}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 3, 11, 15}};
+    EXPECT(check_convolution_backwards(ys, xs, ws, {1, 0}, {2, 2}, {1, 2}));
+}
+
+TEST_CASE(convolution_backwards_1d)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {1, 3, 300}};
+    migraphx::shape ws{migraphx::shape::float_type, {3, 2, 4}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 2, 303}};
+    EXPECT(check_convolution_backwards(ys, xs, ws, {0}, {1}, {1}));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
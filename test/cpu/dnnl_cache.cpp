@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+
+static migraphx::shape conv_output(const migraphx::shape& xs, const migraphx::shape& ws)
+{
+    return migraphx::make_op("convolution").compute_shape({xs, ws});
+}
+
+// Finalizing a dnnl::convolution looks its primitive up in the cache once
+static void finalize_conv(migraphx::context& ctx,
+                          const migraphx::shape& xs,
+                          const migraphx::shape& ws)
+{
+    auto op  = migraphx::make_op("dnnl::convolution");
+    auto out = conv_output(xs, ws);
+    op.finalize(ctx, out, {xs, ws, out});
+}
+
+// Restores the capacity of the process-wide cache when the test is done
+struct cache_guard
+{
+    std::size_t capacity = migraphx::cpu::get_dnnl_cache_stats().capacity;
+    cache_guard() { migraphx::cpu::clear_dnnl_cache(); }
+    cache_guard(const cache_guard&)            = delete;
+    cache_guard& operator=(const cache_guard&) = delete;
+    ~cache_guard()
+    {
+        migraphx::cpu::set_dnnl_cache_capacity(capacity);
+        migraphx::cpu::clear_dnnl_cache();
+    }
+};
+
+static const migraphx::shape xs1{migraphx::shape::float_type, {1, 8, 16, 16}};
+static const migraphx::shape xs2{migraphx::shape::float_type, {1, 8, 12, 12}};
+static const migraphx::shape ws{migraphx::shape::float_type, {8, 8, 3, 3}};
+
+TEST_CASE(identical_convolutions_share_primitive)
+{
+    cache_guard guard;
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto before           = migraphx::cpu::get_dnnl_cache_stats();
+    finalize_conv(ctx, xs1, ws);
+    finalize_conv(ctx, xs1, ws);
+    auto after = migraphx::cpu::get_dnnl_cache_stats();
+    EXPECT(after.misses - before.misses == 1);
+    EXPECT(after.hits - before.hits == 1);
+    EXPECT(after.size == 1);
+}
+
+TEST_CASE(shrink_evicts_least_recently_used)
+{
+    cache_guard guard;
+    migraphx::context ctx = migraphx::cpu::context{};
+    finalize_conv(ctx, xs1, ws);
+    finalize_conv(ctx, xs2, ws);
+    auto before = migraphx::cpu::get_dnnl_cache_stats();
+    EXPECT(before.size == 2);
+    // The first convolution is the least recently used
+    migraphx::cpu::set_dnnl_cache_capacity(1);
+    auto shrunk = migraphx::cpu::get_dnnl_cache_stats();
+    EXPECT(shrunk.evictions - before.evictions == 1);
+    EXPECT(shrunk.size == 1);
+    finalize_conv(ctx, xs2, ws);
+    finalize_conv(ctx, xs1, ws);
+    auto after = migraphx::cpu::get_dnnl_cache_stats();
+    EXPECT(after.hits - shrunk.hits == 1);
+    EXPECT(after.misses - shrunk.misses == 1);
+    EXPECT(after.evictions - shrunk.evictions == 1);
+    EXPECT(after.size == 1);
+}
+
+TEST_CASE(zero_capacity_does_not_cache)
+{
+    cache_guard guard;
+    migraphx::cpu::set_dnnl_cache_capacity(0);
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto before           = migraphx::cpu::get_dnnl_cache_stats();
+    auto out              = conv_output(xs1, ws);
+    auto x                = migraphx::generate_argument(xs1, 0);
+    auto w                = migraphx::generate_argument(ws, 1);
+    std::vector<std::vector<float>> results;
+    for(int i = 0; i < 2; i++)
+    {
+        auto op = migraphx::make_op("dnnl::convolution");
+        op.finalize(ctx, out, {xs1, ws, out});
+        op.compute(ctx, out, {x, w, migraphx::argument{out}}).visit([&](auto r) {
+            results.emplace_back(r.begin(), r.end());
+        });
+    }
+    auto after = migraphx::cpu::get_dnnl_cache_stats();
+    EXPECT(after.misses - before.misses == 2);
+    EXPECT(after.hits == before.hits);
+    EXPECT(after.size == 0);
+    EXPECT(migraphx::verify::verify_rms_range(results[0], results[1]));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
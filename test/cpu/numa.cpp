@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <test.hpp>
+
+static bool same_cpus(const cpu_set_t& x, const cpu_set_t& y) { return CPU_EQUAL(&x, &y) != 0; }
+
+static cpu_set_t get_affinity(pthread_t t)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    pthread_getaffinity_np(t, sizeof(set), &set);
+    return set;
+}
+
+TEST_CASE(numa_nodes)
+{
+    const auto& nodes = migraphx::cpu::get_numa_nodes();
+    EXPECT(not nodes.empty());
+    EXPECT(std::any_of(nodes.begin(), nodes.end(), [](const auto& n) { return not n.empty(); }));
+    EXPECT(migraphx::cpu::get_current_numa_node() < nodes.size());
+}
+
+TEST_CASE(parse_nodes)
+{
+    EXPECT(migraphx::cpu::parse_numa_nodes("").empty());
+    EXPECT(migraphx::cpu::parse_numa_nodes("0") == std::vector<std::size_t>{0});
+    auto n = std::to_string(migraphx::cpu::get_numa_nodes().size());
+    EXPECT(test::throws<migraphx::exception>([&] { migraphx::cpu::parse_numa_nodes(n); }));
+}
+
+TEST_CASE(pin_workers)
+{
+    auto self = get_affinity(pthread_self());
+    auto node = migraphx::cpu::get_current_numa_node();
+    migraphx::cpu::pin_workers_to_numa_nodes({node});
+    // The calling thread is not pinned
+    EXPECT(same_cpus(get_affinity(pthread_self()), self));
+    cpu_set_t expected;
+    CPU_ZERO(&expected);
+    for(auto c : migraphx::cpu::get_numa_nodes()[node])
+        CPU_SET(c, &expected);
+    for(auto handle : migraphx::get_thread_pool().native_handles())
+        EXPECT(same_cpus(get_affinity(handle), expected));
+}
+
+TEST_CASE(context_copies_do_not_pin)
+{
+    auto self = get_affinity(pthread_self());
+    migraphx::cpu::context ctx;
+    auto copy = ctx;
+    EXPECT(same_cpus(get_affinity(pthread_self()), self));
+}
+
+TEST_CASE(first_touch)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1024, 1024}};
+    auto a = migraphx::cpu::allocate_first_touch(s, 4);
+    EXPECT(a.get_shape() == s);
+    auto v = a.get<float>();
+    EXPECT(std::all_of(v.begin(), v.end(), [](float x) { return x == 0; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
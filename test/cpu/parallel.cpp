@@ -0,0 +1,49 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <test.hpp>
+
+TEST_CASE(intra_op_threads_are_restored)
+{
+    auto threads = migraphx::cpu::max_threads();
+    migraphx::cpu::context ctx{2};
+    {
+        auto limit = ctx.limit_intra_op_threads();
+#ifndef MIGRAPHX_DISABLE_OMP
+        EXPECT(migraphx::cpu::max_threads() == ctx.get_intra_op_threads());
+#endif
+    }
+    EXPECT(migraphx::cpu::max_threads() == threads);
+}
+
+TEST_CASE(single_stream_does_not_limit)
+{
+    auto threads = migraphx::cpu::max_threads();
+    migraphx::cpu::context ctx{1};
+    auto limit = ctx.limit_intra_op_threads();
+    EXPECT(migraphx::cpu::max_threads() == threads);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/perfdb.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/tune_ops.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <test.hpp>
+
+static migraphx::value conv_problem(std::size_t channels)
+{
+    return {{"op", "convolution"}, {"channels", channels}};
+}
+
+TEST_CASE(store_find)
+{
+    migraphx::tmp_dir td{"perfdb"};
+    auto path = td.path / "perf.db";
+    {
+        migraphx::cpu::perfdb db{path};
+        EXPECT(not db.find("dnnl::convolution", conv_problem(3)).has_value());
+        db.store("dnnl::convolution", conv_problem(3), {{"algo", "convolution_direct"}});
+        EXPECT(db.find("dnnl::convolution", conv_problem(3)).value() ==
+               migraphx::value{{"algo", "convolution_direct"}});
+    }
+    // The solutions are read back by later compiles
+    migraphx::cpu::perfdb db{path};
+    EXPECT(db.find("dnnl::convolution", conv_problem(3)).value() ==
+           migraphx::value{{"algo", "convolution_direct"}});
+    EXPECT(not db.find("dnnl::convolution", conv_problem(4)).has_value());
+    EXPECT(not db.find("dnnl::quant_convolution", conv_problem(3)).has_value());
+}
+
+static migraphx::module create_conv_module()
+{
+    migraphx::module m;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 16, 16}};
+    migraphx::shape ws{migraphx::shape::float_type, {8, 8, 3, 3}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 8, 14, 14}};
+    auto x = m.add_parameter("x", xs);
+    auto w = m.add_literal(migraphx::generate_literal(ws));
+    auto y = m.add_parameter("y", ys);
+    m.add_instruction(migraphx::make_op("dnnl::convolution"), x, w, y);
+    return m;
+}
+
+static std::string get_algo(const migraphx::module& m)
+{
+    auto ins = std::find_if(
+        m.begin(), m.end(), [](const auto& i) { return i.name() == "dnnl::convolution"; });
+    return ins->get_operator().to_value().at("algo").to<std::string>();
+}
+
+TEST_CASE(tune_lookup)
+{
+    migraphx::tmp_dir td{"perfdb"};
+    auto path = (td.path / "perf.db").string();
+    migraphx::cpu::context ctx;
+    auto m1 = create_conv_module();
+    migraphx::run_passes(m1, {migraphx::cpu::tune_ops{&ctx, true, path}});
+    auto algo = get_algo(m1);
+    EXPECT(migraphx::contains({"convolution_auto", "convolution_direct", "convolution_winograd"},
+                              algo));
+    // Without exhaustive tuning, the solution stored by the first pass is used
+    auto m2 = create_conv_module();
+    migraphx::run_passes(m2, {migraphx::cpu::tune_ops{&ctx, false, path}});
+    EXPECT(get_algo(m2) == algo);
+    migraphx::tmp_dir empty{"perfdb"};
+    auto m3 = create_conv_module();
+    migraphx::run_passes(m3,
+                         {migraphx::cpu::tune_ops{&ctx, false, (empty.path / "perf.db").string()}});
+    EXPECT(get_algo(m3) == "convolution_auto");
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
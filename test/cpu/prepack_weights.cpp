@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+
+static std::vector<float> run(migraphx::operation op,
+                              migraphx::context& ctx,
+                              const migraphx::shape& out,
+                              const std::vector<migraphx::argument>& inputs)
+{
+    auto args = inputs;
+    args.push_back(migraphx::argument{out});
+    op.finalize(ctx, out, migraphx::to_shapes(args));
+    std::vector<float> result;
+    op.compute(ctx, out, args).visit([&](auto r) { result.assign(r.begin(), r.end()); });
+    return result;
+}
+
+// The weights of a saved program can be packed in a layout the primitive does not choose on
+// this machine, so they are reordered instead of failing
+TEST_CASE(finalize_mismatched_packed_desc)
+{
+    migraphx::context ctx = migraphx::cpu::context{};
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 16, 16}};
+    migraphx::shape ws{migraphx::shape::float_type, {8, 8, 3, 3}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 8, 14, 14}};
+    auto x = migraphx::generate_argument(xs, 0);
+    auto w = migraphx::generate_argument(ws, 1);
+
+    auto op       = migraphx::make_op("dnnl::convolution");
+    auto expected = run(op, ctx, ys, {x, w});
+
+    auto v             = op.to_value();
+    v["prepacked"]     = true;
+    v["weights_shape"] = migraphx::to_value(ws);
+    auto prepacked     = migraphx::make_op("dnnl::convolution", v);
+    auto info          = migraphx::compile(prepacked, ctx, ys, {xs, ws, ys});
+    // Pack the weights in the plain layout, as another machine or dnnl version could
+    v["packed_desc"] = info.at("weights_desc");
+    v["packed_isa"]  = "another isa";
+    migraphx::argument packed{migraphx::shape{migraphx::shape::uint8_type, {ws.bytes()}},
+                              w.data()};
+    auto result = run(migraphx::make_op("dnnl::convolution", v), ctx, ys, {x, packed});
+    EXPECT(migraphx::verify::verify_rms_range(result, expected));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
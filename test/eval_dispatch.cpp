@@ -0,0 +1,78 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <unordered_map>
+#include "test.hpp"
+
+// Evaluate the main module the way the evaluator did before the execution plan resolved the
+// normalized operators. The driver's dispatch command compares the time of both evaluations.
+static migraphx::argument eval_normalize_each(const migraphx::program& p,
+                                              const migraphx::parameter_map& params)
+{
+    const auto* mm = p.get_main_module();
+    std::unordered_map<migraphx::instruction_ref, migraphx::argument> results;
+    std::vector<migraphx::argument> values;
+    migraphx::argument last;
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() == "@param")
+        {
+            last = params.at(migraphx::any_cast<migraphx::builtin::param>(ins->get_operator())
+                                 .parameter);
+        }
+        else
+        {
+            values.resize(ins->inputs().size());
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           values.begin(),
+                           [&](migraphx::instruction_ref i) { return results.at(i); });
+            last = ins->normalized_operator().compute(ins->get_shape(), values);
+        }
+        results[ins] = last;
+    }
+    return last;
+}
+
+TEST_CASE(normalized_operators)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x = mm->add_parameter("x", s);
+    for(std::size_t i = 0; i < 4; i++)
+    {
+        x = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {-1}}}), x);
+        x = mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), x);
+    }
+
+    migraphx::parameter_map params = {{"x", migraphx::generate_argument(s)}};
+    EXPECT(eval_normalize_each(p, params) == p.eval(params).back());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
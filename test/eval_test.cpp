@@ -23,12 +23,19 @@
  */
 
 #include <migraphx/program.hpp>
+#include <migraphx/execution_plan.hpp>
+#include <migraphx/execution_state.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/pass.hpp>
+#include <migraphx/register_target.hpp>
+#include <atomic>
 #include <sstream>
+#include <thread>
 #include "test.hpp"
 #include <basic_ops.hpp>
 
@@ -412,6 +419,456 @@ TEST_CASE(target_test)
     EXPECT(result != migraphx::literal{4});
 }
 
+TEST_CASE(target_copy_test)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(migraphx::make_op("add"), one, two);
+    p1.compile(id_target{});
+    migraphx::program p2 = p1;
+    p1                   = migraphx::program{};
+    auto result          = p2.eval({}).back();
+    EXPECT(result == migraphx::literal{3});
+}
+
+TEST_CASE(target_modified_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(migraphx::make_op("add"), one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    mm->add_instruction(migraphx::make_op("add"), sum, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{5});
+}
+
+TEST_CASE(target_replace_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(migraphx::make_op("add"), one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    mm->replace_instruction(sum, migraphx::make_op("sub"), two, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+    migraphx::instruction::replace_argument(sum, one, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{0});
+}
+
+TEST_CASE(plan_stale_test)
+{
+    migraphx::program p1;
+    auto* mm1 = p1.get_main_module();
+    auto x    = mm1->add_literal(1);
+    mm1->add_instruction(migraphx::make_op("add"), x, x);
+    p1.compile(id_target{});
+    migraphx::execution_plan plan{mm1};
+    // Compiling another program does not change the modules of the plan
+    migraphx::program p2;
+    auto* mm2 = p2.get_main_module();
+    auto y    = mm2->add_literal(2);
+    mm2->add_instruction(migraphx::make_op("add"), y, y);
+    p2.compile(id_target{});
+    EXPECT(not plan.is_stale());
+    mm1->add_instruction(migraphx::make_op("add"), x, x);
+    EXPECT(plan.is_stale());
+}
+
+TEST_CASE(target_submodule_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto cond = mm->add_parameter("cond", migraphx::shape{migraphx::shape::bool_type});
+    auto x    = mm->add_parameter("x", s);
+    auto one  = mm->add_literal(1);
+
+    auto* then_mod = p.create_module("If_then");
+    auto r1        = then_mod->add_instruction(migraphx::make_op("add"), x, one);
+    then_mod->add_return({r1});
+
+    auto* else_mod = p.create_module("If_else");
+    auto r2        = else_mod->add_instruction(migraphx::make_op("sub"), x, one);
+    else_mod->add_return({r2});
+
+    auto ret = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), ret);
+    p.compile(id_target{});
+
+    auto run = [&](bool c) {
+        char b = c ? 1 : 0;
+        int xv = 5;
+        migraphx::parameter_map params;
+        params["cond"] = migraphx::argument(migraphx::shape{migraphx::shape::bool_type}, &b);
+        params["x"]    = migraphx::argument(s, &xv);
+        return p.eval(params).back();
+    };
+    EXPECT(run(true) == migraphx::literal{6});
+    EXPECT(run(false) == migraphx::literal{4});
+}
+
+TEST_CASE(execution_state_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(1);
+    mm->add_instruction(migraphx::make_op("add"), x, one);
+    p.compile(id_target{});
+
+    std::vector<migraphx::execution_state> states(4, migraphx::execution_state{p});
+    std::vector<int> results(states.size());
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < states.size(); i++)
+    {
+        threads.emplace_back([&, i] {
+            int xv = static_cast<int>(i);
+            for(int j = 0; j < 100; j++)
+            {
+                auto r     = states[i].eval({{"x", migraphx::argument(s, &xv)}}).back();
+                results[i] = r.at<int>();
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    for(std::size_t i = 0; i < results.size(); i++)
+        EXPECT(results[i] == static_cast<int>(i) + 1);
+}
+
+TEST_CASE(execution_state_empty_test)
+{
+    migraphx::execution_state state;
+    EXPECT(test::throws([&] { state.eval({}); }));
+}
+
+struct count_allocate_op
+{
+    std::shared_ptr<std::atomic<int>> count = std::make_shared<std::atomic<int>>(0);
+    migraphx::shape s;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+    std::string name() const { return "test::allocate"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const { return s; }
+    migraphx::argument compute(const migraphx::shape& output_shape,
+                               const std::vector<migraphx::argument>&) const
+    {
+        (*count)++;
+        return migraphx::argument{output_shape};
+    }
+};
+
+struct add_one_op
+{
+    std::string name() const { return "add_one"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.back();
+    }
+    migraphx::argument compute(const migraphx::shape&,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        auto* out = args.back().cast<int>();
+        auto* in  = args.front().cast<int>();
+        std::transform(in, in + args.front().get_shape().elements(), out, [](int x) {
+            return x + 1;
+        });
+        return args.back();
+    }
+    std::ptrdiff_t output_alias(const std::vector<migraphx::shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+TEST_CASE(execution_state_bind_output_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    count_allocate_op alloc{};
+    alloc.s    = s;
+    auto x     = mm->add_parameter("x", s);
+    auto a     = mm->add_instruction(alloc);
+    auto y     = mm->add_instruction(add_one_op{}, x, a);
+    auto first = mm->add_instruction(add_one_op{}, y, a);
+    mm->add_return({first});
+    p.compile(id_target{});
+
+    std::vector<int> xv = {1, 2, 3, 4};
+    std::vector<int> out(4);
+    migraphx::execution_state state{p};
+    state.bind_output(0, migraphx::argument{s, out.data()});
+    for(int i = 0; i < 2; i++)
+    {
+        auto r = state.eval({{"x", migraphx::argument{s, xv.data()}}});
+        EXPECT(r.front().data() == reinterpret_cast<char*>(out.data()));
+        EXPECT(out == std::vector<int>{3, 4, 5, 6});
+    }
+    EXPECT(alloc.count->load() == 0);
+
+    // Unbound states still allocate the output
+    auto r = migraphx::execution_state{p}.eval({{"x", migraphx::argument{s, xv.data()}}});
+    EXPECT(r.front().data() != reinterpret_cast<char*>(out.data()));
+    EXPECT(alloc.count->load() == 1);
+}
+
+TEST_CASE(execution_state_bind_output_copy_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(1);
+    mm->add_instruction(migraphx::make_op("add"), x, one);
+    p.compile(id_target{});
+
+    int xv  = 2;
+    int out = 0;
+    migraphx::execution_state state{p};
+    state.bind_output("main:#output_0", migraphx::argument{s, &out});
+    auto r = state.eval({{"x", migraphx::argument{s, &xv}}});
+    EXPECT(r.front().data() == reinterpret_cast<char*>(&out));
+    EXPECT(out == 3);
+}
+
+TEST_CASE(execution_state_bind_output_ref_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1, 1}});
+    mm->add_instruction(migraphx::make_op("add"), x, one);
+    p.compile(migraphx::make_target("ref"));
+
+    std::vector<int> xv = {1, 2, 3, 4};
+    std::vector<int> out(4);
+    migraphx::execution_state state{p};
+    state.bind_output(0, migraphx::argument{s, out.data()});
+    for(int i = 0; i < 2; i++)
+    {
+        auto r = state.eval({{"x", migraphx::argument{s, xv.data()}}});
+        EXPECT(r.front().data() == reinterpret_cast<char*>(out.data()));
+        EXPECT(out == std::vector<int>{2, 3, 4, 5});
+    }
+}
+
+TEST_CASE(execution_state_bind_output_error_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {2}};
+    auto x = mm->add_parameter("x", s);
+    mm->add_instruction(pass_op{}, x);
+    p.compile(id_target{});
+
+    std::vector<int> out(4);
+    migraphx::execution_state state{p};
+    migraphx::shape s4{migraphx::shape::int32_type, {4}};
+    migraphx::shape sf{migraphx::shape::float_type, {2}};
+    EXPECT(test::throws([&] { state.bind_output(1, migraphx::argument{s, out.data()}); }));
+    EXPECT(test::throws([&] { state.bind_output(0, migraphx::argument{s4, out.data()}); }));
+    EXPECT(test::throws([&] { state.bind_output(0, migraphx::argument{sf, out.data()}); }));
+    EXPECT(test::throws([&] { state.bind_output("y", migraphx::argument{s, out.data()}); }));
+    EXPECT(test::throws(
+        [&] { state.bind_output("main:#output_", migraphx::argument{s, out.data()}); }));
+    EXPECT(test::throws(
+        [&] { migraphx::execution_state{}.bind_output(0, migraphx::argument{s, out.data()}); }));
+}
+
+struct stream_op
+{
+    std::string attribute;
+    std::size_t n = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.attribute, "attribute"), f(self.n, "n"));
+    }
+    std::string name() const { return "stream_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const { return {}; }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        return {};
+    }
+    migraphx::value attributes() const { return {{attribute, n}}; }
+};
+
+struct double_op
+{
+    std::string name() const { return "double"; }
+    migraphx::argument compute(id_target::context&,
+                               const migraphx::shape& output_shape,
+                               std::vector<migraphx::argument> args) const
+    {
+        migraphx::argument result{output_shape};
+        *result.cast<int>() = args.front().at<int>() * 2;
+        return result;
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+};
+
+struct stream_model
+{
+    std::size_t concurrency() const { return 2; }
+    void sched(migraphx::module& m, migraphx::instruction_ref ins, std::size_t n) const
+    {
+        m.insert_instruction(ins, stream_op{"set_stream", n});
+    }
+    void wait(migraphx::module& m, migraphx::instruction_ref ins, std::size_t wait_id) const
+    {
+        m.insert_instruction(ins, stream_op{"wait_event", wait_id});
+    }
+    void record(migraphx::module& m, migraphx::instruction_ref ins, std::size_t wait_id) const
+    {
+        m.insert_instruction(std::next(ins), stream_op{"record_event", wait_id});
+    }
+    std::size_t weight(const migraphx::operation& op) const
+    {
+        return op.name() == "double" ? 4 : 1;
+    }
+};
+
+struct stream_target : id_target
+{
+    std::string name() const { return "stream"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {migraphx::schedule{stream_model{}}};
+    }
+};
+
+TEST_CASE(concurrent_eval_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto x  = mm->add_parameter("x", s);
+    auto a1 = mm->add_instruction(double_op{}, x);
+    auto a2 = mm->add_instruction(double_op{}, a1);
+    auto b1 = mm->add_instruction(double_op{}, x);
+    auto b2 = mm->add_instruction(double_op{}, b1);
+    auto b3 = mm->add_instruction(double_op{}, b2);
+    // The streams only wait for the operators that need the context
+    mm->add_instruction(sum_op{}, a2, b3);
+    p.compile(stream_target{});
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.get_operator().attributes().contains("set_stream");
+    }));
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.get_operator().attributes().contains("wait_event");
+    }));
+
+    for(int i = 0; i < 100; i++)
+    {
+        auto r = p.eval({{"x", migraphx::argument(s, &i)}}).back();
+        EXPECT(r.at<int>() == 12 * i);
+    }
+}
+
+TEST_CASE(concurrent_eval_error_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto x  = mm->add_parameter("x", s);
+    auto y  = mm->add_parameter("y", s);
+    auto a1 = mm->add_instruction(double_op{}, x);
+    auto a2 = mm->add_instruction(double_op{}, a1);
+    auto b1 = mm->add_instruction(double_op{}, y);
+    auto b2 = mm->add_instruction(double_op{}, b1);
+    mm->add_instruction(migraphx::make_op("add"), a2, b2);
+    p.compile(stream_target{});
+
+    int xv = 1;
+    EXPECT(test::throws([&] { p.eval({{"x", migraphx::argument(s, &xv)}}); }));
+}
+
+// Evaluates its submodule for every element of the input at the same time
+struct concurrent_map_op
+{
+    std::string name() const { return "concurrent_map_op"; }
+
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs,
+                                  const std::vector<migraphx::module_ref>&) const
+    {
+        return inputs.front();
+    }
+
+    migraphx::argument
+    compute(const migraphx::shape& out_shape,
+            const std::vector<migraphx::argument>& args,
+            const std::vector<migraphx::module_ref>& mods,
+            const std::function<std::vector<migraphx::argument>(
+                migraphx::module_ref&, const std::unordered_map<std::string, migraphx::argument>&)>&
+                run) const
+    {
+        migraphx::argument result{out_shape};
+        auto* output = result.cast<int>();
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < out_shape.elements(); i++)
+        {
+            threads.emplace_back([&, i] {
+                auto mod  = mods.front();
+                bool same = true;
+                for(int j = 0; j < 100; j++)
+                {
+                    auto v = run(mod, {{"y", args.front().element(i)}}).front().at<int>();
+                    same      = same and (j == 0 or v == output[i]);
+                    output[i] = v;
+                }
+                if(not same)
+                    output[i] = -1;
+            });
+        }
+        for(auto& t : threads)
+            t.join();
+        return result;
+    }
+};
+
+TEST_CASE(concurrent_submodule_eval_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {8}};
+    migraphx::shape ss{migraphx::shape::int32_type};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(1);
+
+    // The submodule also reads an instruction of the main module
+    auto* smod = p.create_module("sub");
+    auto y     = smod->add_parameter("y", ss);
+    auto yy    = smod->add_instruction(migraphx::make_op("add"), y, y);
+    auto r     = smod->add_instruction(migraphx::make_op("add"), yy, one);
+    smod->add_return({r});
+
+    mm->add_instruction(concurrent_map_op{}, {x}, {smod});
+    p.compile(id_target{});
+
+    std::vector<int> xv = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto result         = p.eval({{"x", migraphx::argument(s, xv.data())}}).back();
+    std::vector<int> gold(xv.size());
+    std::transform(xv.begin(), xv.end(), gold.begin(), [](int v) { return 2 * v + 1; });
+    EXPECT(result == migraphx::argument(s, gold.data()));
+}
+
 TEST_CASE(invert_target_test)
 {
     migraphx::program p;
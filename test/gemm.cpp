@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/gemm.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <migraphx/half.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <test.hpp>
+
+// Compute each element separately with the full index math
+template <class T, class U>
+static void naive_gemm(migraphx::tensor_view<T> cmat,
+                       migraphx::tensor_view<U> amat,
+                       migraphx::tensor_view<U> bmat)
+{
+    const auto& cs = cmat.get_shape();
+    auto dim_0     = cs.ndim() - 2;
+    auto dim_1     = cs.ndim() - 1;
+    auto k         = amat.get_shape().lens()[dim_1];
+    for(std::size_t i = 0; i < cs.elements(); i++)
+    {
+        auto c_idx = cs.multi(i);
+        auto a_idx = c_idx;
+        auto b_idx = c_idx;
+        double s   = 0.0;
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            a_idx[dim_1] = b_idx[dim_0] = kk;
+            s += static_cast<double>(amat(a_idx.begin(), a_idx.end())) *
+                 static_cast<double>(bmat(b_idx.begin(), b_idx.end()));
+        }
+        cmat(c_idx.begin(), c_idx.end()) = static_cast<T>(s);
+    }
+}
+
+template <class T, class U>
+static bool check_gemm(const migraphx::shape& cs,
+                       const migraphx::shape& as,
+                       const migraphx::shape& bs,
+                       double tolerance = 1e-4)
+{
+    auto a = migraphx::generate_argument(as, 1);
+    auto b = migraphx::generate_argument(bs, 2);
+    std::vector<T> expected(cs.elements());
+    std::vector<T> result(cs.elements());
+    migraphx::tensor_view<T> ev{cs, expected.data()};
+    migraphx::tensor_view<T> rv{cs, result.data()};
+    auto av = migraphx::make_view(as, reinterpret_cast<U*>(a.data()));
+    auto bv = migraphx::make_view(bs, reinterpret_cast<U*>(b.data()));
+    naive_gemm(ev, av, bv);
+    migraphx::gemm(rv, av, bv, 1.0f, 0.0f);
+    return std::equal(expected.begin(), expected.end(), result.begin(), [&](auto x, auto y) {
+        auto dx = static_cast<double>(x);
+        auto dy = static_cast<double>(y);
+        return std::abs(dx - dy) <= tolerance * std::max(1.0, std::abs(dx));
+    });
+}
+
+TEST_CASE(gemm_float_blocks)
+{
+    // Sizes that are not multiples of the blocks, with k spanning several blocks
+    migraphx::shape as{migraphx::shape::float_type, {67, 300}};
+    migraphx::shape bs{migraphx::shape::float_type, {300, 259}};
+    migraphx::shape cs{migraphx::shape::float_type, {67, 259}};
+    EXPECT(check_gemm<float, float>(cs, as, bs));
+}
+
+TEST_CASE(gemm_float_transposed)
+{
+    migraphx::shape as{migraphx::shape::float_type, {5, 17}, {1, 5}};
+    migraphx::shape bs{migraphx::shape::float_type, {17, 33}, {1, 17}};
+    migraphx::shape cs{migraphx::shape::float_type, {5, 33}};
+    EXPECT(check_gemm<float, float>(cs, as, bs));
+}
+
+TEST_CASE(gemm_float_broadcast_batch)
+{
+    migraphx::shape as{migraphx::shape::float_type, {2, 3, 7, 9}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 9, 11}, {0, 99, 11, 1}};
+    migraphx::shape cs{migraphx::shape::float_type, {2, 3, 7, 11}};
+    EXPECT(check_gemm<float, float>(cs, as, bs));
+}
+
+TEST_CASE(gemm_int8)
+{
+    migraphx::shape as{migraphx::shape::int8_type, {3, 19, 70}};
+    migraphx::shape bs{migraphx::shape::int8_type, {3, 70, 21}};
+    migraphx::shape cs{migraphx::shape::int32_type, {3, 19, 21}};
+    EXPECT(check_gemm<std::int32_t, std::int8_t>(cs, as, bs, 0));
+}
+
+TEST_CASE(gemm_half)
+{
+    migraphx::shape as{migraphx::shape::half_type, {9, 20}};
+    migraphx::shape bs{migraphx::shape::half_type, {20, 18}};
+    migraphx::shape cs{migraphx::shape::half_type, {9, 18}};
+    EXPECT(check_gemm<migraphx::half, migraphx::half>(cs, as, bs, 1e-2));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
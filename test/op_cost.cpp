@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/op_cost.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include "test.hpp"
+
+TEST_CASE(dot_cost)
+{
+    migraphx::shape a{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape b{migraphx::shape::float_type, {2, 4, 5}};
+    migraphx::shape c{migraphx::shape::float_type, {2, 3, 5}};
+    auto cost = migraphx::make_op("dot").cost(c, {a, b});
+    EXPECT(cost.flops == 2.0 * 2 * 3 * 5 * 4);
+    EXPECT(cost.bytes_read == a.bytes() + b.bytes());
+    EXPECT(cost.bytes_written == c.bytes());
+    EXPECT(cost.intensity() == cost.flops / cost.bytes());
+}
+
+TEST_CASE(convolution_cost)
+{
+    migraphx::shape x{migraphx::shape::float_type, {1, 4, 8, 8}};
+    migraphx::shape w{migraphx::shape::float_type, {6, 2, 3, 3}};
+    auto op   = migraphx::make_op("convolution", {{"group", 2}});
+    auto out  = op.compute_shape({x, w});
+    auto cost = op.cost(out, {x, w});
+    EXPECT(cost.flops == 2.0 * out.elements() * 2 * 3 * 3);
+    EXPECT(cost.bytes_read == x.bytes() + w.bytes());
+    EXPECT(cost.bytes_written == out.bytes());
+}
+
+TEST_CASE(pooling_cost)
+{
+    migraphx::shape x{migraphx::shape::float_type, {1, 2, 4, 4}};
+    auto op   = migraphx::make_op("pooling", {{"lengths", {2, 2}}, {"stride", {2, 2}}});
+    auto out  = op.compute_shape({x});
+    auto cost = op.cost(out, {x});
+    EXPECT(cost.flops == out.elements() * 4.0);
+    EXPECT(cost.bytes_read == x.bytes());
+}
+
+TEST_CASE(reduce_cost)
+{
+    migraphx::shape x{migraphx::shape::float_type, {3, 8}};
+    auto op   = migraphx::make_op("reduce_sum", {{"axes", {1}}});
+    auto out  = op.compute_shape({x});
+    auto cost = op.cost(out, {x});
+    EXPECT(cost.flops == x.elements());
+    EXPECT(cost.bytes_written == out.bytes());
+}
+
+TEST_CASE(gather_cost)
+{
+    migraphx::shape data{migraphx::shape::float_type, {100, 4}};
+    migraphx::shape indices{migraphx::shape::int32_type, {3}};
+    auto op   = migraphx::make_op("gather", {{"axis", 0}});
+    auto out  = op.compute_shape({data, indices});
+    auto cost = op.cost(out, {data, indices});
+    EXPECT(cost.flops == 0);
+    EXPECT(cost.bytes_read == out.bytes() + indices.bytes());
+    EXPECT(cost.bytes_written == out.bytes());
+}
+
+TEST_CASE(pointwise_cost)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module pm;
+    auto x = pm.add_parameter("x0", migraphx::shape{migraphx::shape::float_type});
+    auto y = pm.add_parameter("x1", migraphx::shape{migraphx::shape::float_type});
+    auto z = pm.add_instruction(migraphx::make_op("add"), x, y);
+    pm.add_return({pm.add_instruction(migraphx::make_op("mul"), z, y)});
+    auto op   = migraphx::make_op("pointwise");
+    auto cost = op.cost(s, {s, s}, {&pm});
+    EXPECT(cost.flops == 2.0 * s.elements());
+    EXPECT(cost.bytes_read == 2 * s.bytes());
+    EXPECT(cost.bytes_written == s.bytes());
+}
+
+TEST_CASE(unary_cost)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto cost = migraphx::make_op("relu").cost(s, {s});
+    EXPECT(cost.flops == s.elements());
+    EXPECT(cost.bytes() == 2 * s.bytes());
+}
+
+TEST_CASE(default_cost)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto op = migraphx::make_op("identity");
+    EXPECT(op.cost(s, {s}).empty());
+    EXPECT(op.cost(s, {s}, {}).empty());
+    EXPECT(migraphx::cost(op, s, {s}).empty());
+}
+
+TEST_CASE(accumulate_cost)
+{
+    migraphx::op_cost x{4, 8, 2};
+    migraphx::op_cost y{2, 4, 6};
+    auto z = x + y;
+    EXPECT(z == migraphx::op_cost{6, 12, 8});
+    EXPECT(z.bytes() == 20);
+    EXPECT(migraphx::op_cost{}.intensity() == 0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
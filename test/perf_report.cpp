@@ -24,6 +24,7 @@
 #include <migraphx/program.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
 #include <migraphx/register_target.hpp>
 #include "test.hpp"
 
@@ -50,4 +51,28 @@ TEST_CASE(perf_report)
     EXPECT(not migraphx::contains(output, "fast"));
 }
 
+TEST_CASE(perf_report_cost)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    std::stringstream ss;
+    migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+    auto a = mm->add_parameter("a", s);
+    auto b = mm->add_parameter("b", s);
+    auto d = mm->add_instruction(migraphx::make_op("dot"), a, b);
+    mm->add_instruction(migraphx::make_op("relu"), d);
+    p.compile(migraphx::make_target("ref"));
+    migraphx::parameter_map params;
+    params["a"] = migraphx::generate_argument(s);
+    params["b"] = migraphx::generate_argument(s);
+    p.perf_report(ss, 2, params);
+
+    std::string output = ss.str();
+    EXPECT(migraphx::contains(output, "GFLOP/s"));
+    EXPECT(migraphx::contains(output, "GB/s"));
+    EXPECT(migraphx::contains(output, "flops/byte"));
+    EXPECT(migraphx::contains(output, "Total GFLOP:"));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
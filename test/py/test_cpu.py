@@ -21,7 +21,7 @@
 # OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 # THE SOFTWARE.
 #####################################################################################
-import migraphx, array, sys
+import migraphx, array, sys, json, os
 
 
 def test_conv_relu():
@@ -43,6 +43,57 @@ def test_conv_relu():
     print(r)
 
 
+def test_execution_state():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    states = [migraphx.execution_state(p) for _ in range(2)]
+    r = p.run(params)[-1]
+    for state in states:
+        assert state.run(params)[-1] == r
+
+
+def test_execution_state_bind_output():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    s = p.get_output_shapes()[-1]
+    out = memoryview(array.array('f', [0.0] * s.elements())).cast('B').cast(
+        'f', s.lens())
+    state = migraphx.execution_state(p)
+    state.bind_output(0, out)
+    r = state.run(params)[-1]
+    assert r == p.run(params)[-1]
+    assert migraphx.argument(out) == r
+
+
+def test_run_with_trace():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    trace_file = "test_run_with_trace.json"
+    r = p.run_with_trace(params, trace_file)[-1]
+    assert r == p.run(params)[-1]
+    with open(trace_file) as f:
+        trace = json.load(f)
+    os.remove(trace_file)
+    names = [e["name"] for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert "eval" in names
+    assert len(names) > 1
+
+
 def create_buffer(t, data, shape):
     a = array.array(t, data)
     if sys.version_info >= (3, 0):
@@ -84,6 +135,9 @@ def test_module():
 
 
 test_conv_relu()
+test_execution_state()
+test_execution_state_bind_output()
+test_run_with_trace()
 test_module()
 if sys.version_info >= (3, 0):
     test_add_scalar()
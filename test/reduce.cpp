@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/reduce.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include <test.hpp>
+
+using lens_t = std::vector<std::size_t>;
+
+// Sum each output separately by checking every element of the input
+static std::vector<double> naive_sum(const migraphx::shape& in_shape,
+                                     const migraphx::shape& out_shape,
+                                     const std::vector<float>& data)
+{
+    migraphx::shape out_std{out_shape.type(), out_shape.lens()};
+    std::vector<double> result(out_shape.elements());
+    for(std::size_t i = 0; i < in_shape.elements(); i++)
+    {
+        auto idx = in_shape.multi(i);
+        for(std::size_t d = 0; d < idx.size(); d++)
+        {
+            if(out_shape.lens()[d] == 1)
+                idx[d] = 0;
+        }
+        result[out_std.index(idx)] += data[in_shape.index(i)];
+    }
+    return result;
+}
+
+static bool check_sum(const migraphx::shape& in_shape, const migraphx::shape& out_shape)
+{
+    std::vector<float> data(in_shape.element_space());
+    std::generate(data.begin(), data.end(), [i = 0]() mutable { return (i++ % 23) - 11.0f; });
+    std::vector<float> result(out_shape.element_space());
+    migraphx::reduce(migraphx::make_view(out_shape, result.data()),
+                     migraphx::make_view(in_shape, data.data()),
+                     [](auto x, auto y) { return x + y; },
+                     0.0,
+                     [](auto x) { return static_cast<double>(x); },
+                     [](auto x) { return x; });
+    auto expected = naive_sum(in_shape, out_shape, data);
+    auto output   = migraphx::make_view(out_shape, result.data());
+    for(std::size_t i = 0; i < expected.size(); i++)
+    {
+        if(std::abs(output[i] - expected[i]) > 1e-3)
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(reduce_inner)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {3, 5, 1000}};
+    migraphx::shape ys{migraphx::shape::float_type, {3, 5, 1}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_inner_rows)
+{
+    // The reduced dimensions are not next to each other
+    migraphx::shape xs{migraphx::shape::float_type, {4, 6, 7, 33}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 6, 1, 1}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_outer)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {64, 300}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 300}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_middle)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {2, 50, 70}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 1, 70}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_transposed)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {8, 9, 10}, {1, 80, 8}};
+    migraphx::shape ys{migraphx::shape::float_type, {8, 1, 10}, {1, 80, 8}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_broadcasted)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {5, 40, 6}, {6, 0, 1}};
+    migraphx::shape ys{migraphx::shape::float_type, {5, 1, 1}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_all)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {7, 11, 13}};
+    migraphx::shape ys{migraphx::shape::float_type, {1, 1, 1}};
+    EXPECT(check_sum(xs, ys));
+}
+
+TEST_CASE(reduce_none)
+{
+    migraphx::shape xs{migraphx::shape::float_type, {4, 1, 5}};
+    migraphx::shape ys{migraphx::shape::float_type, {4, 1, 5}};
+    EXPECT(check_sum(xs, ys));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
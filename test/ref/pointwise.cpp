@@ -21,12 +21,15 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <migraphx/arena.hpp>
+#include <migraphx/eval_pointwise.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
+#include <numeric>
 
 #include <test.hpp>
 
@@ -49,3 +52,110 @@ TEST_CASE(pointwise_test)
     std::vector<float> gold = {0, 2, 4};
     EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
 }
+
+TEST_CASE(pointwise_broadcast_literal_test)
+{
+    // Several blocks of elements, with a broadcasted input and a literal in the submodule
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 40, 50}};
+    migraphx::shape bs{migraphx::shape::float_type, {3}};
+    std::vector<float> xdata(s.elements());
+    std::iota(xdata.begin(), xdata.end(), -1000);
+    auto x   = mm->add_literal(migraphx::literal{s, xdata});
+    auto b   = mm->add_literal(migraphx::literal{bs, {1, 2, 3}});
+    auto bb  = mm->add_instruction(
+        migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", s.lens()}}), b);
+    auto* pm = p.create_module("pointwise");
+    auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+    auto two = pm->add_literal(2.0f);
+    auto mul = pm->add_instruction(migraphx::make_op("mul"), x1, two);
+    auto add = pm->add_instruction(migraphx::make_op("add"), mul, x2);
+    pm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::int32_type}}), add);
+    mm->add_instruction(migraphx::make_op("pointwise"), {x, bb}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<int> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<int> gold(s.elements());
+    for(std::size_t i = 0; i < gold.size(); i++)
+        gold[i] = static_cast<int>(xdata[i] * 2) + static_cast<int>(i / (40 * 50) % 3) + 1;
+    EXPECT(results_vector == gold);
+}
+
+TEST_CASE(pointwise_transposed_test)
+{
+    // The output follows the layout of the transposed inputs, and the standard one is gathered
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {30, 70}};
+    std::vector<float> xdata(s.elements());
+    std::vector<float> ydata(s.elements());
+    std::iota(xdata.begin(), xdata.end(), 0);
+    std::iota(ydata.begin(), ydata.end(), 5000);
+    auto x  = mm->add_literal(migraphx::literal{s, xdata});
+    auto y  = mm->add_literal(migraphx::literal{s, ydata});
+    auto z  = mm->add_literal(migraphx::literal{s, ydata});
+    auto xt = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+    auto yt = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), y);
+    auto zr = mm->add_instruction(migraphx::make_op("reshape", {{"dims", {70, 30}}}), z);
+    auto* pm = p.create_module("pointwise");
+    auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+    auto x3  = pm->add_parameter("x3", {migraphx::shape::float_type});
+    auto sub = pm->add_instruction(migraphx::make_op("sub"), x2, x1);
+    pm->add_instruction(migraphx::make_op("add"), sub, x3);
+    mm->add_instruction(migraphx::make_op("pointwise"), {xt, yt, zr}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(s.elements());
+    for(std::size_t i = 0; i < 70; i++)
+    {
+        for(std::size_t j = 0; j < 30; j++)
+            gold[i * 30 + j] = ydata[j * 70 + i] - xdata[j * 70 + i] + ydata[i * 30 + j];
+    }
+    EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
+}
+
+TEST_CASE(pointwise_arena_test)
+{
+    // Only the output is allocated from the arena of the evaluation, the steps of each block
+    // reuse a scratch arena
+    migraphx::module pm;
+    auto x1  = pm.add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm.add_parameter("x2", {migraphx::shape::float_type});
+    auto add = pm.add_instruction(migraphx::make_op("add"), x1, x2);
+    auto mul = pm.add_instruction(migraphx::make_op("mul"), add, x1);
+    pm.add_instruction(migraphx::make_op("sub"), mul, x2);
+    migraphx::shape s{migraphx::shape::float_type, {64, 1024}};
+    migraphx::shape ts{migraphx::shape::float_type, {64, 1024}, {1, 64}};
+    std::vector<float> xdata(s.elements());
+    std::iota(xdata.begin(), xdata.end(), 0);
+    migraphx::argument x{s, xdata.data()};
+    migraphx::argument y{ts, xdata.data()};
+    migraphx::arena a;
+    migraphx::argument result;
+    {
+        migraphx::arena_scope scope{a};
+        result = migraphx::eval_pointwise(nullptr, s, &pm, {"x1", "x2"}, {x, y});
+    }
+    EXPECT(not result.empty());
+    EXPECT(a.get_stats().high_water == s.bytes());
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(s.elements());
+    for(std::size_t i = 0; i < 64; i++)
+    {
+        for(std::size_t j = 0; j < 1024; j++)
+        {
+            auto a1 = xdata[i * 1024 + j];
+            auto a2 = xdata[j * 64 + i];
+            gold[i * 1024 + j] = (a1 + a2) * a1 - a2;
+        }
+    }
+    EXPECT(migraphx::verify::verify_rms_range(results_vector, gold));
+}
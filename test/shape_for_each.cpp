@@ -0,0 +1,146 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/shape.hpp>
+#include <atomic>
+#include <vector>
+#include <test.hpp>
+
+using lens_t = std::vector<std::size_t>;
+
+// Walks the shape with a stride_walker of capacity N and checks every index and offset against
+// shape::multi and shape::index
+template <std::size_t N>
+static bool check_walk(const migraphx::shape& s, std::size_t start = 0)
+{
+    migraphx::shape std_s{s.type(), s.lens()};
+    migraphx::stride_walker<N, 2> w{s.lens(), std::array{s.strides(), std_s.strides()}, start};
+    bool ok = true;
+    auto i  = start;
+    w.for_each(s.elements() - start, [&](const auto& idx, const auto& offsets) {
+        auto expected = s.multi(i);
+        ok            = ok and std::equal(idx.begin(), idx.end(), expected.begin(), expected.end());
+        ok            = ok and offsets[0] == s.index(expected) and offsets[1] == i;
+        i++;
+    });
+    return ok and i == s.elements();
+}
+
+TEST_CASE(multi_index_next)
+{
+    lens_t lens = {2, 3, 4};
+    migraphx::shape s{migraphx::shape::float_type, lens};
+    migraphx::multi_index<migraphx::max_inline_rank> idx{lens};
+    for(std::size_t i = 0; i < s.elements(); i++)
+    {
+        auto expected = s.multi(i);
+        EXPECT(std::equal(idx.begin(), idx.end(), expected.begin(), expected.end()));
+        ++idx;
+    }
+    EXPECT(idx[0] == 2);
+}
+
+TEST_CASE(multi_index_increment)
+{
+    lens_t lens = {3, 5, 7, 2};
+    migraphx::shape s{migraphx::shape::float_type, lens};
+    for(std::size_t start : {0, 1, 13, 50})
+    {
+        for(std::size_t n : {0, 1, 6, 15, 70})
+        {
+            if(start + n >= s.elements())
+                continue;
+            migraphx::multi_index<> idx{lens, start};
+            idx += n;
+            auto expected = s.multi(start + n);
+            EXPECT(std::equal(idx.begin(), idx.end(), expected.begin(), expected.end()));
+        }
+    }
+}
+
+TEST_CASE(stride_walker_standard)
+{
+    EXPECT(check_walk<migraphx::max_inline_rank>({migraphx::shape::float_type, {2, 3, 4, 5}}));
+    EXPECT(check_walk<0>({migraphx::shape::float_type, {2, 3, 4, 5}}));
+}
+
+TEST_CASE(stride_walker_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 5}, {1, 20, 4}};
+    EXPECT(check_walk<migraphx::max_inline_rank>(s));
+    EXPECT(check_walk<migraphx::max_inline_rank>(s, 17));
+}
+
+TEST_CASE(stride_walker_broadcasted)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 4, 5}, {0, 5, 1}};
+    EXPECT(check_walk<migraphx::max_inline_rank>(s));
+    EXPECT(check_walk<0>(s, 21));
+}
+
+TEST_CASE(stride_walker_large_rank)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 1, 3, 2, 1, 2, 3, 2}};
+    auto t = migraphx::shape::from_permutation(s.type(), s.lens(), {7, 6, 5, 4, 3, 2, 1, 0});
+    EXPECT(check_walk<0>(s));
+    EXPECT(check_walk<0>(t, 5));
+}
+
+TEST_CASE(stride_walker_rows)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 4, 5}, {1, 15, 3}};
+    migraphx::stride_walker<migraphx::max_inline_rank, 1> w{s.lens(), std::array{s.strides()}, 2};
+    std::vector<std::size_t> offsets;
+    w.for_each_row(s.elements() - 4, [&](const auto& o, std::size_t n) {
+        for(std::size_t j = 0; j < n; j++)
+            offsets.push_back(o[0] + j * w.inner_stride(0));
+    });
+    EXPECT(offsets.size() == s.elements() - 4);
+    for(std::size_t i = 0; i < offsets.size(); i++)
+        EXPECT(offsets[i] == s.index(i + 2));
+    EXPECT(w.offset(0) == s.index(s.elements() - 2));
+}
+
+TEST_CASE(par_strided_for_each_all)
+{
+    migraphx::shape s{migraphx::shape::float_type, {7, 11, 13}, {1, 91, 7}};
+    std::vector<std::atomic<int>> visited(s.element_space());
+    migraphx::par_strided_for_each(
+        s.lens(), std::array{s.strides()}, 16, [&](const auto& offsets) { visited[offsets[0]]++; });
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](const auto& v) { return v == 1; }));
+}
+
+TEST_CASE(shape_for_each_order)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 1, 4, 2}, {1, 3, 6, 3}};
+    std::size_t count = 0;
+    migraphx::shape_for_each(s, [&](const auto& idx, std::size_t i) {
+        EXPECT(i == count);
+        EXPECT(idx == s.multi(i));
+        count++;
+    });
+    EXPECT(count == s.elements());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
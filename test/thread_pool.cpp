@@ -0,0 +1,143 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/par.hpp>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(submit)
+{
+    migraphx::thread_pool pool{2};
+    std::promise<bool> p;
+    auto f = p.get_future();
+    pool.submit([&] { p.set_value(pool.is_worker()); });
+    EXPECT(f.get());
+    EXPECT(not pool.is_worker());
+}
+
+TEST_CASE(parallel_for_all)
+{
+    migraphx::thread_pool pool{4};
+    std::vector<int> counts(1000);
+    pool.parallel_for(counts.size(), 1, [&](std::size_t start, std::size_t last, std::size_t) {
+        for(auto i = start; i < last; i++)
+            counts[i]++;
+    });
+    EXPECT(std::all_of(counts.begin(), counts.end(), [](int c) { return c == 1; }));
+}
+
+TEST_CASE(parallel_for_tid)
+{
+    migraphx::thread_pool pool{3};
+    std::vector<std::atomic<int>> tids(pool.size() + 1);
+    pool.parallel_for(1000, 1, [&](std::size_t start, std::size_t last, std::size_t tid) {
+        EXPECT(tid < tids.size());
+        tids.at(tid) += last - start;
+    });
+    auto total = std::accumulate(
+        tids.begin(), tids.end(), 0, [](int x, const std::atomic<int>& y) { return x + y; });
+    EXPECT(total == 1000);
+}
+
+TEST_CASE(parallel_for_max_threads)
+{
+    migraphx::thread_pool pool{4};
+    std::atomic<std::size_t> max_tid{0};
+    pool.parallel_for(1000, 1, 2, [&](std::size_t, std::size_t, std::size_t tid) {
+        auto m = max_tid.load();
+        while(m < tid and not max_tid.compare_exchange_weak(m, tid)) {}
+    });
+    EXPECT(max_tid.load() < 2);
+}
+
+TEST_CASE(parallel_for_nested)
+{
+    migraphx::thread_pool pool{2};
+    std::atomic<int> total{0};
+    pool.parallel_for(64, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+        for(auto i = start; i < last; i++)
+        {
+            pool.parallel_for(64, 1, [&](std::size_t s, std::size_t l, std::size_t) {
+                total += static_cast<int>(l - s);
+            });
+        }
+    });
+    EXPECT(total.load() == 64 * 64);
+}
+
+TEST_CASE(parallel_for_exception)
+{
+    migraphx::thread_pool pool{2};
+    EXPECT(test::throws<std::runtime_error>([&] {
+        pool.parallel_for(100, 1, [&](std::size_t start, std::size_t last, std::size_t) {
+            if(start <= 50 and 50 < last)
+                throw std::runtime_error("error");
+        });
+    }));
+}
+
+TEST_CASE(stats)
+{
+    migraphx::thread_pool pool{2};
+    pool.parallel_for(1000, 1, [](std::size_t, std::size_t, std::size_t) {});
+    auto s = pool.get_stats();
+    EXPECT(s.tasks > 0);
+    pool.reset_stats();
+    EXPECT(pool.get_stats().tasks == 0);
+}
+
+TEST_CASE(native_handles)
+{
+    migraphx::thread_pool pool{3};
+    auto handles = pool.native_handles();
+    EXPECT(handles.size() == pool.size());
+    std::sort(handles.begin(), handles.end());
+    EXPECT(bool{std::adjacent_find(handles.begin(), handles.end()) == handles.end()});
+}
+
+TEST_CASE(par_for_all)
+{
+    std::vector<int> counts(1000);
+    migraphx::par_for(counts.size(), [&](std::size_t i) { counts[i]++; });
+    EXPECT(std::all_of(counts.begin(), counts.end(), [](int c) { return c == 1; }));
+}
+
+TEST_CASE(par_transform_all)
+{
+    std::vector<int> x(10000);
+    std::iota(x.begin(), x.end(), 0);
+    std::vector<int> y(x.size());
+    auto last = migraphx::par_transform(x.begin(), x.end(), y.begin(), [](int i) { return 2 * i; });
+    EXPECT(last - y.begin() == x.size());
+    std::vector<int> z(x.size());
+    std::transform(x.begin(), x.end(), z.begin(), [](int i) { return 2 * i; });
+    EXPECT(y == z);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,130 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2024 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/timeline.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/execution_state.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <algorithm>
+#include <thread>
+#include <test.hpp>
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_literal(migraphx::generate_literal(s));
+    auto sum = mm->add_instruction(migraphx::make_op("add"), x, y);
+    mm->add_instruction(migraphx::make_op("relu"), sum);
+    p.compile(migraphx::make_target("ref"));
+    return p;
+}
+
+static migraphx::parameter_map create_params(const migraphx::program& p)
+{
+    migraphx::parameter_map m;
+    for(auto&& [name, s] : p.get_parameter_shapes())
+        m[name] = migraphx::generate_argument(s);
+    return m;
+}
+
+TEST_CASE(record_instructions)
+{
+    auto p = create_program();
+    migraphx::timeline t;
+    migraphx::execution_environment exec_env;
+    exec_env.trace = &t;
+    auto result    = p.eval(create_params(p), exec_env);
+    EXPECT(result == p.eval(create_params(p)));
+
+    auto events = t.get_events();
+    // The parameters and literals are not recorded
+    EXPECT(events.size() == 3);
+    EXPECT(events.back().name == "eval");
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    const auto& add = events.front();
+    EXPECT(add.name == "ref::add");
+    EXPECT(add.instruction == "@2");
+    EXPECT(add.inputs == std::vector<migraphx::shape>{s, s});
+    EXPECT(add.output == s);
+    EXPECT(add.bytes == 3 * s.bytes());
+    EXPECT(add.tid == 0);
+    EXPECT(std::all_of(events.begin(), events.end(), [&](const auto& e) {
+        return e.duration_us >= 0 and e.start_us >= events.back().start_us;
+    }));
+}
+
+TEST_CASE(chrome_trace)
+{
+    auto p = create_program();
+    migraphx::timeline t;
+    migraphx::execution_environment exec_env;
+    exec_env.trace = &t;
+    p.eval(create_params(p), exec_env);
+    p.eval(create_params(p), exec_env);
+
+    auto trace  = migraphx::from_json_string(t.to_chrome_trace());
+    auto events = trace.at("traceEvents");
+    auto is_phase = [](const std::string& ph) {
+        return [=](const migraphx::value& e) { return e.at("ph").to<std::string>() == ph; };
+    };
+    EXPECT(std::count_if(events.begin(), events.end(), is_phase("X")) == 6);
+    EXPECT(std::count_if(events.begin(), events.end(), is_phase("M")) == 1);
+    auto first = std::find_if(events.begin(), events.end(), is_phase("X"));
+    EXPECT(first->at("tid").to<std::size_t>() == 0);
+    EXPECT(first->at("args").at("instruction").to<std::string>() == "@2");
+    EXPECT(first->at("args").at("inputs").size() == 2);
+
+    t.clear();
+    EXPECT(t.get_events().empty());
+}
+
+TEST_CASE(concurrent_states)
+{
+    auto p      = create_program();
+    auto params = create_params(p);
+    migraphx::timeline t;
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 2; i++)
+    {
+        threads.emplace_back([&] {
+            migraphx::execution_state state{p};
+            migraphx::execution_environment exec_env;
+            exec_env.trace = &t;
+            state.eval(params, exec_env);
+        });
+    }
+    for(auto& th : threads)
+        th.join();
+    auto events = t.get_events();
+    EXPECT(events.size() == 6);
+    EXPECT(std::any_of(events.begin(), events.end(), [](const auto& e) { return e.tid == 1; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
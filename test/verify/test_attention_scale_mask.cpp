@@ -0,0 +1,58 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_attention_scale_mask : verify_program<test_attention_scale_mask>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {2, 3, 150, 16}};
+        migraphx::shape ms{migraphx::shape::float_type, {150, 150}};
+        auto q  = mm->add_parameter("q", s);
+        auto k  = mm->add_parameter("k", s);
+        auto v  = mm->add_parameter("v", s);
+        auto kt = mm->add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+
+        auto gemm  = mm->add_instruction(migraphx::make_op("dot"), q, kt);
+        auto scale = mm->add_literal(0.25f);
+        auto sb    = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", gemm->get_shape().lens()}}), scale);
+        auto mul   = mm->add_instruction(migraphx::make_op("mul"), gemm, sb);
+
+        auto mask = mm->add_literal(migraphx::generate_literal(ms, 3));
+        auto mb   = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", gemm->get_shape().lens()}}), mask);
+        auto add  = mm->add_instruction(migraphx::make_op("add"), mul, mb);
+        auto sm   = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), add);
+        mm->add_instruction(migraphx::make_op("dot"), sm, v);
+        return p;
+    }
+};
@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+
+struct fp16_native
+{
+    static std::string mode() { return "native"; }
+};
+
+struct fp16_storage
+{
+    static std::string mode() { return "storage"; }
+};
+
+struct fp16_float
+{
+    static std::string mode() { return "float"; }
+};
+
+// Operators with and without an fp16 kernel, and fp16 weights that are only converted in some of
+// the modes
+template <class Mode>
+struct test_fp16_mode : verify_program<test_fp16_mode<Mode>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::half_type, {1, 4, 8, 8}};
+        migraphx::shape ws{migraphx::shape::half_type, {4, 4, 3, 3}};
+        migraphx::shape bs{migraphx::shape::half_type, {4}};
+        auto x    = mm->add_parameter("x", xs);
+        auto w    = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto b    = mm->add_literal(migraphx::generate_literal(bs, 2));
+        auto conv = mm->add_instruction(migraphx::make_op("convolution"), x, w);
+        auto bb   = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", conv->get_shape().lens()}}),
+            b);
+        auto add  = mm->add_instruction(migraphx::make_op("add"), conv, bb);
+        auto relu = mm->add_instruction(migraphx::make_op("relu"), add);
+        mm->add_instruction(migraphx::make_op("sin"), relu);
+        return p;
+    }
+
+    migraphx::compile_options get_compile_options() const
+    {
+        migraphx::compile_options options;
+        options.fp16_mode = Mode::mode();
+        return options;
+    }
+};
+
+template struct test_fp16_mode<fp16_native>;
+template struct test_fp16_mode<fp16_storage>;
+template struct test_fp16_mode<fp16_float>;
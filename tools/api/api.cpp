@@ -27,6 +27,7 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/execution_state.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -38,6 +39,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/timeline.hpp>
 #include <array>
 #include <algorithm>
 #include <cstdarg>
@@ -204,6 +206,17 @@ run_async(program& p, const parameter_map& params, void* s, std::string_view nam
     return p.eval(params, exec_env);
 }
 
+std::vector<argument>
+run_with_trace(program& p, const parameter_map& params, const char* trace_file)
+{
+    timeline t;
+    execution_environment exec_env;
+    exec_env.trace = &t;
+    auto result    = p.eval(params, exec_env);
+    t.write_chrome_trace(std::string(trace_file));
+    return result;
+}
+
 template <class Value>
 std::vector<const char*> get_names(const std::unordered_map<std::string, Value>& m)
 {
@@ -287,6 +300,11 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(execution_state& s, const parameter_map& params)
+{
+    return s.eval(params);
+}
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
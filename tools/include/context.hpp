@@ -33,6 +33,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/any_ptr.hpp>
+#include <migraphx/argument.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -44,6 +45,13 @@ inline namespace MIGRAPHX_INLINE_NS {
 /// during `eval`.
 struct context
 {
+    /// Called before the program is evaluated, so the memory allocated by the previous
+    /// evaluation can be reused. It does not modify the context, so a context shared with the
+    /// target is not copied.
+    void reset_memory() const;
+    /// Called with each result of the evaluation, and returns a copy of it when it is in memory
+    /// that the next evaluation reuses
+    argument detach_memory(const argument& result) const;
     /// Wait for any tasks in the context to complete
     void finish() const;
 };
@@ -75,6 +83,17 @@ void wait_for_context(T&, any_ptr)
 template <class T>
 void finish_on_context(T&, any_ptr){}
 
+template <class T>
+void reset_memory_context(const T&)
+{
+}
+
+template <class T>
+argument detach_memory_context(const T&, const argument& result)
+{
+    return result;
+}
+
 <%
  interface('context',
            virtual('to_value', returns = 'value', const = True, default = 'to_value_context'),
@@ -82,6 +101,15 @@ void finish_on_context(T&, any_ptr){}
            virtual('get_queue', returns = 'any_ptr', default = 'get_queue_context'),
            virtual('wait_for', queue = 'any_ptr', returns = 'void', default = 'wait_for_context'),
            virtual('finish_on', queue = 'any_ptr', returns = 'void', default = 'finish_on_context'),
+           virtual('reset_memory',
+                   returns = 'void',
+                   const   = True,
+                   default = 'reset_memory_context'),
+           virtual('detach_memory',
+                   result  = 'const argument&',
+                   returns = 'argument',
+                   const   = True,
+                   default = 'detach_memory_context'),
            virtual('finish', returns = 'void', const = True)) %>
 
     inline void migraphx_to_value(value& v, const context& ctx)
@@ -41,6 +41,7 @@
 #include <migraphx/serialize.hpp>
 #include <migraphx/auto_any_cast.hpp>
 #include <migraphx/lifetime.hpp>
+#include <migraphx/op_cost.hpp>
 #include <migraphx/config.hpp>
 
 namespace migraphx {
@@ -82,6 +83,9 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method that estimates the flops and the bytes read and written for one
+    /// evaluation with the given shapes. Operators that don't implement it report an empty cost.
+    op_cost cost(const shape& output, const std::vector<shape>& input) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -93,6 +97,8 @@ bool is_context_free(const operation& x);
 bool need_normalization(const operation& x);
 /// Returns true if the operation has a finalize method
 bool has_finalize(const operation& x);
+/// Returns the estimated cost of the operation, which is empty when it isn't implemented
+op_cost cost(const operation& x, const shape& output, const std::vector<shape>& inputs);
 
 #else
 
@@ -494,6 +500,55 @@ lifetime get_lifetime_op(const T&)
     return lifetime::local;
 }
 
+template <class T>
+auto cost_op(rank<1>, const T& x, const shape& output, const std::vector<shape>& inputs)
+    -> decltype(x.cost(output, inputs))
+{
+    return x.cost(output, inputs);
+}
+
+template <class T>
+op_cost cost_op(rank<0>, const T&, const shape&, const std::vector<shape>&)
+{
+    return {};
+}
+
+template <class T>
+op_cost cost_op(const T& x, const shape& output, const std::vector<shape>& inputs)
+{
+    return cost_op(rank<1>{}, x, output, inputs);
+}
+
+template <class T>
+auto mod_cost_op(rank<1>,
+                 const T& x,
+                 const shape& output,
+                 const std::vector<shape>& inputs,
+                 const std::vector<module_ref>& mod_args)
+    -> decltype(x.cost(output, inputs, mod_args))
+{
+    return x.cost(output, inputs, mod_args);
+}
+
+template <class T>
+op_cost mod_cost_op(rank<0>,
+                    const T& x,
+                    const shape& output,
+                    const std::vector<shape>& inputs,
+                    const std::vector<module_ref>&)
+{
+    return cost_op(x, output, inputs);
+}
+
+template <class T>
+op_cost mod_cost_op(const T& x,
+                    const shape& output,
+                    const std::vector<shape>& inputs,
+                    const std::vector<module_ref>& mod_args)
+{
+    return mod_cost_op(rank<1>{}, x, output, inputs, mod_args);
+}
+
 } // namespace detail
 
 <%
@@ -573,6 +628,19 @@ lifetime get_lifetime_op(const T&)
      virtual('to_value', returns = 'value', const = True, default = 'detail::to_value_op'),
      virtual('from_value', v = 'const value&', default = 'detail::from_value_op'),
      virtual('attributes', returns = 'value', const = True, default = 'detail::attributes_op'),
+     virtual('cost',
+             returns = 'op_cost',
+             output  = 'const shape&',
+             input   = 'const std::vector<shape>&',
+             const   = True,
+             default = 'detail::cost_op'),
+     virtual('cost',
+             returns  = 'op_cost',
+             output   = 'const shape&',
+             inputs   = 'const std::vector<shape>&',
+             mod_args = 'const std::vector<module_ref>&',
+             const    = True,
+             default  = 'detail::mod_cost_op'),
      friend('operator<<',
             returns = 'std::ostream &',
             os      = 'std::ostream &',
@@ -675,6 +743,17 @@ bool has_finalize(const T& x)
     return detail::has_finalize_op(x);
 }
 
+inline op_cost cost(const operation& op, const shape& output, const std::vector<shape>& inputs)
+{
+    return op.cost(output, inputs);
+}
+
+template <class T>
+op_cost cost(const T& op, const shape& output, const std::vector<shape>& inputs)
+{
+    return detail::cost_op(op, output, inputs);
+}
+
 MIGRAPHX_EXPORT void migraphx_to_value(value& v, const operation& op);
 MIGRAPHX_EXPORT void migraphx_from_value(const value& v, operation& op);
 